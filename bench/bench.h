@@ -0,0 +1,66 @@
+/**
+ * @file        bench.h
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Proc Server Benchmarks Definition Header File
+*/
+
+#ifndef _BENCH_H_
+#define _BENCH_H_
+
+/* Includes ----------------------------------------------- */
+#include <types.h>
+#include <clock.h>
+
+
+/* Exported types ----------------------------------------- */
+
+// Benchmark entry point, argv holds the arguments following the benchmark name
+typedef int32_t (*bench_t)(int argc, const char* argv[]);
+
+
+/* Exported constants ------------------------------------- */
+
+// Benchmark files are created here and removed once they are done
+#define BENCH_DIR           "/proc/user/bench"
+
+
+/* Exported macros ---------------------------------------- */
+
+
+/* Exported functions ------------------------------------- */
+
+// Microseconds taken by the given clock ticks, 0 without a clock source
+uint32_t BenchMicros(uint64_t ticks);
+
+// Nanoseconds per operation
+uint32_t BenchNanos(uint64_t ticks, uint32_t count);
+
+// Kilobytes per second
+uint32_t BenchRate(uint64_t bytes, uint64_t ticks);
+
+// Creates or opens a file and sets its size, returns the descriptor or -1
+int32_t BenchCreate(const char* path, size_t size);
+
+int32_t BenchUnlink(const char* path);
+
+int32_t BenchLookup(int argc, const char* argv[]);
+
+int32_t BenchDispatch(int argc, const char* argv[]);
+
+int32_t BenchWorkers(int argc, const char* argv[]);
+
+int32_t BenchBoot(int argc, const char* argv[]);
+
+int32_t BenchGrow(int argc, const char* argv[]);
+
+int32_t BenchWrite(int argc, const char* argv[]);
+
+int32_t BenchRing(int argc, const char* argv[]);
+
+int32_t BenchCopy(int argc, const char* argv[]);
+
+int32_t BenchFifo(int argc, const char* argv[]);
+
+#endif
@@ -0,0 +1,131 @@
+/**
+ * @file        boot.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Boot Time and Resident Memory Benchmark implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <bench.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+/* Private types ------------------------------------------ */
+
+
+/* Private constants -------------------------------------- */
+#define BOOT_MEMINFO        "/proc/meminfo"
+#define BOOT_FILES          "/proc/boot/"
+
+
+/* Private macros ----------------------------------------- */
+
+
+/* Private variables -------------------------------------- */
+
+
+/* Private function prototypes ---------------------------- */
+
+int32_t BootMeminfo()
+{
+    char buffer[256];
+    int32_t fd = open(BOOT_MEMINFO, O_RDONLY);
+
+    if(fd == -1)
+    {
+        printf("File %s not found\n", BOOT_MEMINFO);
+        return E_INVAL;
+    }
+
+    int32_t size = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+
+    if(size <= 0)
+    {
+        return E_ERROR;
+    }
+
+    buffer[size] = 0;
+    printf("%s", buffer);
+
+    return E_OK;
+}
+
+// Rewrites the first byte of a boot file with its own value, the first write makes the private copy
+int32_t BootCopy(const char* name)
+{
+    char path[128];
+    char byte;
+
+    if((strlen(name) + sizeof(BOOT_FILES)) > sizeof(path))
+    {
+        return E_INVAL;
+    }
+
+    sprintf(path, BOOT_FILES "%s", name);
+
+    int32_t fd = open(path, O_RDWR);
+
+    if(fd == -1)
+    {
+        printf("File %s not found\n", path);
+        return E_INVAL;
+    }
+
+    size_t size = (size_t)lseek(fd, 0, SEEK_END);
+    lseek(fd, 0, SEEK_SET);
+
+    if(read(fd, &byte, 1) != 1)
+    {
+        close(fd);
+        return E_ERROR;
+    }
+
+    lseek(fd, 0, SEEK_SET);
+
+    uint64_t start = ClockTicks();
+    int32_t written = write(fd, &byte, 1);
+    uint64_t ticks = ClockTicks() - start;
+
+    close(fd);
+
+    if(written != 1)
+    {
+        return E_ERROR;
+    }
+
+    printf("First write to %s (%u bytes): %u us\n", path, size, BenchMicros(ticks));
+
+    return E_OK;
+}
+
+
+/* Private functions -------------------------------------- */
+
+int32_t BenchBoot(int argc, const char* argv[])
+{
+    // Clock counts from reset, run this first thing after boot
+    printf("Uptime: %u ms\n", ClockMilliseconds());
+
+    if(BootMeminfo() != E_OK)
+    {
+        return E_ERROR;
+    }
+
+    if(argc < 1)
+    {
+        return E_OK;
+    }
+
+    if(BootCopy(argv[0]) != E_OK)
+    {
+        return E_ERROR;
+    }
+
+    // Resident data grows by the copied file
+    return BootMeminfo();
+}
@@ -0,0 +1,132 @@
+/**
+ * @file        copy.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Copy, Zero Fill and Compare Kernels Benchmark implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <bench.h>
+#include <copy.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mman.h>
+
+
+/* Private types ------------------------------------------ */
+
+// Runs one kernel over size bytes
+typedef void (*kernel_t)(char* dst, char* src, size_t size);
+
+
+/* Private constants -------------------------------------- */
+#define COPY_MAX            (8 * 1024 * 1024)
+#define COPY_BYTES          (16 * 1024 * 1024)  // Moved at every size
+
+
+/* Private macros ----------------------------------------- */
+
+
+/* Private variables -------------------------------------- */
+
+static const uint32_t sizes[] = {64, 256, 1024, 4096, 16 * 1024, 64 * 1024, 256 * 1024, 1024 * 1024, 4 * 1024 * 1024, COPY_MAX};
+
+// Comparisons are not optimized away, every result is added here
+static volatile uint32_t equal;
+
+// Core clock in MHz, bytes per cycle are only reported when it is given
+static uint32_t coreMHz;
+
+
+/* Private function prototypes ---------------------------- */
+
+void KernelCopyBulk(char* dst, char* src, size_t size)  { CopyBulk(dst, src, size); }
+void KernelMemcpy(char* dst, char* src, size_t size)    { memcpy(dst, src, size); }
+void KernelCopyZero(char* dst, char* src, size_t size)  { (void)src; CopyZero(dst, size); }
+void KernelMemset(char* dst, char* src, size_t size)    { (void)src; memset(dst, 0, size); }
+void KernelCopyEqual(char* dst, char* src, size_t size) { equal += CopyEqual(dst, src, size); }
+void KernelMemcmp(char* dst, char* src, size_t size)    { equal += (memcmp(dst, src, size) == 0); }
+
+void CopyReport(const char* name, size_t size, uint64_t ticks)
+{
+    uint64_t bytes = (COPY_BYTES / size) * size;
+
+    printf("  %s: %u kB/s", name, BenchRate(bytes, ticks));
+
+    if((coreMHz != 0) && (ticks != 0))
+    {
+        // Hundredths of a byte per core cycle
+        uint32_t rate = (uint32_t)((bytes * ClockFrequency() * 100) / (ticks * coreMHz * 1000000));
+        printf(", %u.%u%u bytes/cycle", rate / 100, (rate / 10) % 10, rate % 10);
+    }
+
+    printf("\n");
+}
+
+uint64_t CopyRun(kernel_t kernel, char* dst, char* src, size_t size)
+{
+    uint32_t runs = COPY_BYTES / size;
+    uint32_t i;
+
+    uint64_t start = ClockTicks();
+
+    for(i = 0; i < runs; i++)
+    {
+        kernel(dst, src, size);
+    }
+
+    return ClockTicks() - start;
+}
+
+
+/* Private functions -------------------------------------- */
+
+int32_t BenchCopy(int argc, const char* argv[])
+{
+    coreMHz = ((argc >= 1) ? ((uint32_t)strtoul(argv[0], NULL, 10)) : (0));
+
+    // Page aligned like file extents
+    char* src = (char*)mmap(NULL, COPY_MAX, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, NOFD, 0x0);
+    char* dst = (char*)mmap(NULL, COPY_MAX, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, NOFD, 0x0);
+
+    if((src == NULL) || (dst == NULL))
+    {
+        if(src != NULL)
+        {
+            munmap(src, COPY_MAX);
+        }
+
+        if(dst != NULL)
+        {
+            munmap(dst, COPY_MAX);
+        }
+
+        return E_NO_RES;
+    }
+
+    memset(src, 0x5A, COPY_MAX);
+
+    uint32_t n;
+    for(n = 0; n < (sizeof(sizes) / sizeof(sizes[0])); n++)
+    {
+        size_t size = sizes[n];
+
+        printf("%u bytes\n", size);
+        CopyReport("CopyBulk", size, CopyRun(KernelCopyBulk, dst, src, size));
+        CopyReport("memcpy", size, CopyRun(KernelMemcpy, dst, src, size));
+        CopyReport("CopyZero", size, CopyRun(KernelCopyZero, dst, src, size));
+        CopyReport("memset", size, CopyRun(KernelMemset, dst, src, size));
+
+        // Equal buffers are the worst case, every byte is compared
+        memcpy(dst, src, size);
+        CopyReport("CopyEqual", size, CopyRun(KernelCopyEqual, dst, src, size));
+        CopyReport("memcmp", size, CopyRun(KernelMemcmp, dst, src, size));
+    }
+
+    munmap(src, COPY_MAX);
+    munmap(dst, COPY_MAX);
+
+    return E_OK;
+}
@@ -0,0 +1,104 @@
+/**
+ * @file        dispatch.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Per Message Dispatch Benchmark implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <bench.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+/* Private types ------------------------------------------ */
+
+
+/* Private constants -------------------------------------- */
+#define DISPATCH_FILE       BENCH_DIR "/dispatch"
+#define DISPATCH_MESSAGES   10000
+
+
+/* Private macros ----------------------------------------- */
+
+
+/* Private variables -------------------------------------- */
+
+// Connections attached to the server while one of them is timed
+static const uint32_t connections[] = {1, 100, 10000};
+
+
+/* Private function prototypes ---------------------------- */
+
+
+/* Private functions -------------------------------------- */
+
+int32_t BenchDispatch(int argc, const char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    const uint32_t MAX = connections[(sizeof(connections) / sizeof(connections[0])) - 1];
+    int32_t* fds = (int32_t*)malloc(MAX * sizeof(int32_t));
+
+    if(fds == NULL)
+    {
+        return E_NO_RES;
+    }
+
+    fds[0] = BenchCreate(DISPATCH_FILE, 4096);
+
+    if(fds[0] == -1)
+    {
+        free(fds);
+        return E_ERROR;
+    }
+
+    uint32_t opened = 1;
+    uint32_t i, n;
+    int32_t ret = E_OK;
+
+    for(n = 0; n < (sizeof(connections) / sizeof(connections[0])); n++)
+    {
+        // Every open is a connection of its own
+        for( ; opened < connections[n]; opened++)
+        {
+            fds[opened] = open(DISPATCH_FILE, O_RDONLY);
+
+            if(fds[opened] == -1)
+            {
+                printf("Stopped at %u connections\n", opened);
+                ret = E_NO_RES;
+                break;
+            }
+        }
+
+        if(ret != E_OK)
+        {
+            break;
+        }
+
+        // A seek carries no data, its cost is the message round trip and the connection lookup
+        uint64_t start = ClockTicks();
+
+        for(i = 0; i < DISPATCH_MESSAGES; i++)
+        {
+            lseek(fds[0], 0, SEEK_SET);
+        }
+
+        printf("%u connections: %u ns per message\n", opened, BenchNanos(ClockTicks() - start, DISPATCH_MESSAGES));
+    }
+
+    for(i = 0; i < opened; i++)
+    {
+        close(fds[i]);
+    }
+
+    free(fds);
+    BenchUnlink(DISPATCH_FILE);
+
+    return ret;
+}
@@ -0,0 +1,182 @@
+/**
+ * @file        fifo.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       FIFO Throughput and Wakeup Latency Benchmark implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <bench.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <task.h>
+#include <proc_msg.h>
+
+
+/* Private types ------------------------------------------ */
+
+// Consumer side descriptors and results, results are read once the consumer task is joined
+typedef struct
+{
+    int32_t  data;
+    int32_t  ack;
+    uint32_t bytes;
+    uint64_t end;
+    uint32_t wakeups;
+    uint64_t latency;
+}consumer_t;
+
+
+/* Private constants -------------------------------------- */
+#define FIFO_DATA           BENCH_DIR "/fifo"
+#define FIFO_ACK            BENCH_DIR "/fifo_ack"
+#define FIFO_CHUNK          4096
+#define FIFO_BYTES          (16 * 1024 * 1024)
+#define FIFO_PINGS          1000
+
+
+/* Private macros ----------------------------------------- */
+
+
+/* Private variables -------------------------------------- */
+
+
+/* Private function prototypes ---------------------------- */
+
+int32_t FifoOpen(const char* path)
+{
+    int32_t fd = open(path, O_RDWR | O_CREAT | O_FIFO);
+
+    if(fd == -1)
+    {
+        printf("FIFO %s cannot be created\n", path);
+    }
+
+    return fd;
+}
+
+void FifoClose(int32_t data, int32_t ack, consumer_t* consumer)
+{
+    int32_t fds[] = {data, ack, consumer->data, consumer->ack};
+    uint32_t i;
+
+    for(i = 0; i < (sizeof(fds) / sizeof(fds[0])); i++)
+    {
+        if(fds[i] != -1)
+        {
+            close(fds[i]);
+        }
+    }
+
+    BenchUnlink(FIFO_ACK);
+    BenchUnlink(FIFO_DATA);
+}
+
+void* FifoConsumer(void* arg)
+{
+    consumer_t* consumer = (consumer_t*)arg;
+    char buffer[FIFO_CHUNK];
+    int32_t data = consumer->data;
+    int32_t ack = consumer->ack;
+
+    // Reads return what is in the ring, never past the streamed data so the first ping is not taken
+    while(consumer->bytes < FIFO_BYTES)
+    {
+        uint32_t left = FIFO_BYTES - consumer->bytes;
+        int32_t size = read(data, buffer, ((left < FIFO_CHUNK) ? (left) : (FIFO_CHUNK)));
+
+        if(size <= 0)
+        {
+            break;
+        }
+
+        consumer->bytes += size;
+    }
+
+    consumer->end = ClockTicks();
+
+    // Every ping carries the time it was written, the reply is held until it arrives
+    while(consumer->wakeups < FIFO_PINGS)
+    {
+        uint64_t sent;
+
+        if(read(data, &sent, sizeof(sent)) != sizeof(sent))
+        {
+            break;
+        }
+
+        consumer->latency += ClockTicks() - sent;
+        consumer->wakeups++;
+
+        write(ack, buffer, 1);
+    }
+
+    return NULL;
+}
+
+
+/* Private functions -------------------------------------- */
+
+int32_t BenchFifo(int argc, const char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    char buffer[FIFO_CHUNK];
+    int32_t data = FifoOpen(FIFO_DATA);
+    int32_t ack = FifoOpen(FIFO_ACK);
+
+    // Consumer connections are opened here, a producer never waits on a consumer that could not start
+    consumer_t consumer = {open(FIFO_DATA, O_RDONLY), open(FIFO_ACK, O_WRONLY), 0, 0, 0, 0};
+
+    if((data == -1) || (ack == -1) || (consumer.data == -1) || (consumer.ack == -1))
+    {
+        FifoClose(data, ack, &consumer);
+        return E_ERROR;
+    }
+
+    task_t task;
+    taskAttr_t attr = {20, FALSE, 0x200000};
+    uint32_t done, i;
+
+    uint64_t start = ClockTicks();
+
+    TaskCreate(&task, &attr, FifoConsumer, &consumer);
+
+    // Writes wait while the ring is full, the consumer drains it meanwhile
+    for(done = 0; done < FIFO_BYTES; done += FIFO_CHUNK)
+    {
+        if(write(data, buffer, FIFO_CHUNK) != FIFO_CHUNK)
+        {
+            break;
+        }
+    }
+
+    for(i = 0; i < FIFO_PINGS; i++)
+    {
+        // Consumer gets the chance to block on the empty FIFO before the ping
+        SchedYield();
+
+        uint64_t now = ClockTicks();
+
+        if((write(data, &now, sizeof(now)) != sizeof(now)) || (read(ack, buffer, 1) != 1))
+        {
+            break;
+        }
+    }
+
+    TaskJoin(task, NULL);
+
+    printf("Throughput: %u kB/s in %u byte writes\n", BenchRate(consumer.bytes, consumer.end - start), FIFO_CHUNK);
+
+    if(consumer.wakeups != 0)
+    {
+        printf("Wakeup latency: %u ns\n", BenchNanos(consumer.latency, consumer.wakeups));
+    }
+
+    FifoClose(data, ack, &consumer);
+
+    return (((consumer.bytes == FIFO_BYTES) && (consumer.wakeups == FIFO_PINGS)) ? (E_OK) : (E_ERROR));
+}
@@ -0,0 +1,85 @@
+/**
+ * @file        grow.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       File Growth Benchmark implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <bench.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+/* Private types ------------------------------------------ */
+
+
+/* Private constants -------------------------------------- */
+#define GROW_FILE           BENCH_DIR "/grow"
+#define GROW_STEP           4096
+#define GROW_MAX            (64 * 1024 * 1024)
+
+
+/* Private macros ----------------------------------------- */
+
+
+/* Private variables -------------------------------------- */
+
+
+/* Private function prototypes ---------------------------- */
+
+
+/* Private functions -------------------------------------- */
+
+int32_t BenchGrow(int argc, const char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    int32_t fd = BenchCreate(GROW_FILE, GROW_STEP);
+
+    if(fd == -1)
+    {
+        return E_ERROR;
+    }
+
+    uint32_t size = GROW_STEP;
+    uint32_t mark = GROW_STEP;
+    uint64_t total = 0;
+    uint64_t segment = 0;
+    int32_t ret = E_OK;
+
+    // Per step cost stays the same as the file doubles when growing does not copy
+    while(size < GROW_MAX)
+    {
+        size += GROW_STEP;
+
+        uint64_t start = ClockTicks();
+        int32_t grown = ftruncate(fd, size);
+        uint64_t ticks = ClockTicks() - start;
+
+        if(grown != E_OK)
+        {
+            printf("Stopped at %u bytes\n", size - GROW_STEP);
+            ret = E_NO_RES;
+            break;
+        }
+
+        total += ticks;
+        segment += ticks;
+
+        if(size == (mark << 1))
+        {
+            printf("%u kB: %u us total, %u ns per step\n", size / 1024, BenchMicros(total), BenchNanos(segment, mark / GROW_STEP));
+            mark = size;
+            segment = 0;
+        }
+    }
+
+    close(fd);
+    BenchUnlink(GROW_FILE);
+
+    return ret;
+}
@@ -0,0 +1,95 @@
+/**
+ * @file        lookup.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Directory Lookup Benchmark implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <bench.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+/* Private types ------------------------------------------ */
+
+
+/* Private constants -------------------------------------- */
+#define LOOKUP_DIR          BENCH_DIR "/lookup"
+#define LOOKUP_OPENS        1000
+#define LOOKUP_STRIDE       7919    // Prime, consecutive opens land far apart in the directory
+
+
+/* Private macros ----------------------------------------- */
+
+
+/* Private variables -------------------------------------- */
+
+// Directory sizes measured, each one adds entries to the previous
+static const uint32_t sizes[] = {10, 100, 1000, 10000, 100000};
+
+
+/* Private function prototypes ---------------------------- */
+
+
+/* Private functions -------------------------------------- */
+
+int32_t BenchLookup(int argc, const char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    char path[64];
+    uint32_t created = 0;
+    uint32_t i, n;
+    int32_t ret = E_OK;
+
+    for(n = 0; n < (sizeof(sizes) / sizeof(sizes[0])); n++)
+    {
+        for( ; created < sizes[n]; created++)
+        {
+            sprintf(path, LOOKUP_DIR "/f%u", created);
+            int32_t fd = open(path, O_RDWR | O_CREAT);
+
+            if(fd == -1)
+            {
+                printf("Stopped at %u entries\n", created);
+                ret = E_NO_RES;
+                break;
+            }
+
+            close(fd);
+        }
+
+        if(ret != E_OK)
+        {
+            break;
+        }
+
+        // Path formatting is timed too, it costs the same at every size
+        uint64_t start = ClockTicks();
+
+        for(i = 0; i < LOOKUP_OPENS; i++)
+        {
+            sprintf(path, LOOKUP_DIR "/f%u", (i * LOOKUP_STRIDE) % created);
+            int32_t fd = open(path, O_RDONLY);
+
+            if(fd != -1)
+            {
+                close(fd);
+            }
+        }
+
+        printf("%u entries: %u ns per open and close\n", created, BenchNanos(ClockTicks() - start, LOOKUP_OPENS));
+    }
+
+    for(i = 0; i < created; i++)
+    {
+        sprintf(path, LOOKUP_DIR "/f%u", i);
+        BenchUnlink(path);
+    }
+
+    return ret;
+}
@@ -0,0 +1,124 @@
+#include <types.h>
+#include <io_types.h>
+#include <server.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <proc_msg.h>
+#include <bench.h>
+
+static struct
+{
+    const char* name;
+    bench_t     run;
+    const char* usage;
+}benches[]
+    = {{"lookup", BenchLookup, "open latency against directory size"},
+       {"dispatch", BenchDispatch, "message cost against attached connections"},
+       {"workers", BenchWorkers, "read throughput against reading tasks"},
+       {"boot", BenchBoot, "uptime and memory, [file] times the first write to /proc/boot/file"},
+       {"grow", BenchGrow, "growing a file from 4 kB to 64 MB a page at a time"},
+       {"write", BenchWrite, "write throughput for 4 kB, 64 kB and 4 MB writes"},
+       {"ring", BenchRing, "64 byte random reads, submission ring against MsgSend"},
+       {"copy", BenchCopy, "proc copy kernels against the library, [core MHz] adds bytes per cycle"},
+       {"fifo", BenchFifo, "FIFO throughput and reader wakeup latency"}};
+
+#define BENCHES     (sizeof(benches) / sizeof(benches[0]))
+
+uint32_t BenchMicros(uint64_t ticks)
+{
+    uint32_t hz = ClockFrequency();
+
+    return ((hz == 0) ? (0) : ((uint32_t)((ticks * 1000000) / hz)));
+}
+
+uint32_t BenchNanos(uint64_t ticks, uint32_t count)
+{
+    uint32_t hz = ClockFrequency();
+
+    if((hz == 0) || (count == 0))
+    {
+        return 0;
+    }
+
+    return (uint32_t)(((ticks * 1000000000) / hz) / count);
+}
+
+uint32_t BenchRate(uint64_t bytes, uint64_t ticks)
+{
+    uint32_t hz = ClockFrequency();
+
+    return ((ticks == 0) ? (0) : ((uint32_t)(((bytes * hz) / ticks) / 1024)));
+}
+
+int32_t BenchCreate(const char* path, size_t size)
+{
+    int32_t fd = open(path, O_RDWR | O_CREAT);
+
+    if(fd == -1)
+    {
+        printf("File %s cannot be created\n", path);
+        return -1;
+    }
+
+    if((size != 0) && (ftruncate(fd, size) != E_OK))
+    {
+        printf("File %s cannot be resized to %u bytes\n", path, size);
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+int32_t BenchUnlink(const char* path)
+{
+    char* remaining = NULL;
+    int32_t fd = connect(path, &remaining);
+
+    if(fd == -1)
+    {
+        return E_INVAL;
+    }
+
+    // Message header
+    io_hdr_t hdr;
+    hdr.type = _IO_INFO;
+    hdr.code = INFO_UNLINK;
+    hdr.sbytes = strlen(remaining) + 1;
+    hdr.rbytes = 0;
+    uint32_t replySize;
+
+    int32_t ret = MsgSend(fd, &hdr, remaining, NULL, &replySize);
+
+    ConnectDetach(fd);
+
+    return ret;
+}
+
+int main(int argc, const char* argv[])
+{
+    uint32_t i;
+
+    if(argc >= 2)
+    {
+        for(i = 0; i < BENCHES; i++)
+        {
+            if(!strcmp(argv[1], benches[i].name))
+            {
+                printf("Clock: %u Hz\n", ClockFrequency());
+                return benches[i].run(argc - 2, &argv[2]);
+            }
+        }
+    }
+
+    printf("Usage: bench name [args]\n");
+
+    for(i = 0; i < BENCHES; i++)
+    {
+        printf("  %s: %s\n", benches[i].name, benches[i].usage);
+    }
+
+    return E_INVAL;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file        ring.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Submission Ring Benchmark implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <bench.h>
+#include <io_types.h>
+#include <server.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <mman.h>
+#include <proc_msg.h>
+
+
+/* Private types ------------------------------------------ */
+
+
+/* Private constants -------------------------------------- */
+#define RING_FILE           BENCH_DIR "/ring"
+#define RING_FILE_SIZE      (1024 * 1024)
+#define RING_READ_SIZE      64
+#define RING_READS          10000
+#define RING_ENTRIES        64
+#define RING_BATCH          32
+#define RING_PAGE_SIZE      4096
+
+
+/* Private macros ----------------------------------------- */
+#define ALIGN_UP(m,a)	(((m) + (a - 1)) & (~(a - 1)))
+
+// Random read positions, the same sequence for both paths
+#define RING_NEXT(seed)     ((seed) * 1103515245 + 12345)
+#define RING_OFFSET(seed)   (((seed) >> 8) % (RING_FILE_SIZE / RING_READ_SIZE) * RING_READ_SIZE)
+
+
+/* Private variables -------------------------------------- */
+
+
+/* Private function prototypes ---------------------------- */
+
+// Descriptors are proc connections, messages with handle 0 reach the file opened on them
+int32_t RingSend(int32_t fd, uint16_t code, const void* request, uint32_t sbytes, void* reply, uint32_t rbytes)
+{
+    io_hdr_t hdr;
+    hdr.type = _IO_READ;
+    hdr.code = code;
+    hdr.sbytes = sbytes;
+    hdr.rbytes = rbytes;
+    uint32_t replySize;
+
+    return MsgSend(fd, &hdr, (const char*)request, (const char*)reply, &replySize);
+}
+
+// One message per read
+uint64_t RingSync(int32_t fd)
+{
+    char buffer[RING_READ_SIZE];
+    uint32_t seed = 1;
+    uint32_t i;
+
+    uint64_t start = ClockTicks();
+
+    for(i = 0; i < RING_READS; i++)
+    {
+        seed = RING_NEXT(seed);
+        off_t pos = RING_OFFSET(seed);
+        RingSend(fd, IO_READ_AT, &pos, sizeof(off_t), buffer, RING_READ_SIZE);
+    }
+
+    return ClockTicks() - start;
+}
+
+// One message per batch, returns 0 if the ring cannot be set up
+uint64_t RingBatched(int32_t fd)
+{
+    ring_setup_t setup = {RING_ENTRIES, RING_ENTRIES * RING_READ_SIZE};
+
+    if(RingSend(fd, IO_READ_RING_SETUP, &setup, sizeof(setup), NULL, 0) != E_OK)
+    {
+        printf("Ring setup failed\n");
+        return 0;
+    }
+
+    // Same layout as the server computes, the header holds the offsets
+    uint32_t cqOffset = ALIGN_UP(sizeof(ring_hdr_t), 8) + RING_ENTRIES * sizeof(ring_sqe_t);
+    size_t size = ALIGN_UP(ALIGN_UP(cqOffset + RING_ENTRIES * sizeof(ring_cqe_t), 8) + setup.dataSize, RING_PAGE_SIZE);
+
+    ring_hdr_t* hdr = (ring_hdr_t*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0x0);
+
+    if(hdr == NULL)
+    {
+        printf("Ring cannot be mapped\n");
+        return 0;
+    }
+
+    ring_sqe_t* sq = (ring_sqe_t*)((char*)hdr + hdr->sqOffset);
+    ring_cqe_t* cq = (ring_cqe_t*)((char*)hdr + hdr->cqOffset);
+    uint32_t mask = hdr->entries - 1;
+    uint32_t seed = 1;
+    uint32_t done = 0;
+
+    uint64_t start = ClockTicks();
+
+    while(done < RING_READS)
+    {
+        uint32_t tail = hdr->sqTail;
+        uint32_t i;
+
+        for(i = 0; (i < RING_BATCH) && ((done + i) < RING_READS); i++, tail++)
+        {
+            seed = RING_NEXT(seed);
+
+            ring_sqe_t* sqe = &sq[tail & mask];
+            sqe->op = RING_OP_READ;
+            sqe->tag = done + i;
+            sqe->offset = RING_OFFSET(seed);
+            sqe->size = RING_READ_SIZE;
+            sqe->data = (tail & mask) * RING_READ_SIZE;
+        }
+
+        // Entries are written before the server can see the tail
+        __sync_synchronize();
+        hdr->sqTail = tail;
+
+        RingSend(fd, IO_READ_RING_ENTER, NULL, 0, NULL, 0);
+
+        // Completions are consumed so the next batch finds room
+        while(hdr->cqHead != hdr->cqTail)
+        {
+            if(cq[hdr->cqHead & mask].result != RING_READ_SIZE)
+            {
+                printf("Ring read %u failed\n", cq[hdr->cqHead & mask].tag);
+            }
+
+            hdr->cqHead++;
+            done++;
+        }
+    }
+
+    uint64_t ticks = ClockTicks() - start;
+
+    munmap(hdr, size);
+
+    return ticks;
+}
+
+
+/* Private functions -------------------------------------- */
+
+int32_t BenchRing(int argc, const char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    int32_t fd = BenchCreate(RING_FILE, RING_FILE_SIZE);
+
+    if(fd == -1)
+    {
+        return E_ERROR;
+    }
+
+    // Ring is set up on a connection of its own, it replaces mapping the file data
+    int32_t ringFd = open(RING_FILE, O_RDWR);
+
+    if(ringFd == -1)
+    {
+        close(fd);
+        BenchUnlink(RING_FILE);
+        return E_ERROR;
+    }
+
+    uint64_t sync = RingSync(fd);
+    uint64_t ring = RingBatched(ringFd);
+
+    printf("MsgSend: %u ns per %u byte read\n", BenchNanos(sync, RING_READS), RING_READ_SIZE);
+
+    if(ring != 0)
+    {
+        printf("Ring: %u ns per %u byte read, batches of %u\n", BenchNanos(ring, RING_READS), RING_READ_SIZE, RING_BATCH);
+        printf("Speedup: %u.%u\n", (uint32_t)(sync / ring), (uint32_t)(((sync % ring) * 10) / ring));
+    }
+
+    close(ringFd);
+    close(fd);
+    BenchUnlink(RING_FILE);
+
+    return ((ring != 0) ? (E_OK) : (E_ERROR));
+}
@@ -0,0 +1,115 @@
+/**
+ * @file        workers.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Concurrent Read Throughput Benchmark implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <bench.h>
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <task.h>
+
+
+/* Private types ------------------------------------------ */
+
+
+/* Private constants -------------------------------------- */
+#define WORKERS_FILE        BENCH_DIR "/workers"
+#define WORKERS_FILE_SIZE   (1024 * 1024)
+#define WORKERS_CHUNK       4096
+#define WORKERS_BYTES       (8 * 1024 * 1024)   // Read by every task
+#define WORKERS_MAX         8
+
+
+/* Private macros ----------------------------------------- */
+
+
+/* Private variables -------------------------------------- */
+
+
+/* Private function prototypes ---------------------------- */
+
+void* WorkersTask(void* arg)
+{
+    (void)arg;
+
+    char buffer[WORKERS_CHUNK];
+    uint32_t done = 0;
+
+    // Each task has its own connection so requests reach the server independently
+    int32_t fd = open(WORKERS_FILE, O_RDONLY);
+
+    if(fd == -1)
+    {
+        return NULL;
+    }
+
+    while(done < WORKERS_BYTES)
+    {
+        if((done % WORKERS_FILE_SIZE) == 0)
+        {
+            lseek(fd, 0, SEEK_SET);
+        }
+
+        if(read(fd, buffer, WORKERS_CHUNK) != WORKERS_CHUNK)
+        {
+            break;
+        }
+
+        done += WORKERS_CHUNK;
+    }
+
+    close(fd);
+
+    return NULL;
+}
+
+
+/* Private functions -------------------------------------- */
+
+int32_t BenchWorkers(int argc, const char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    int32_t fd = BenchCreate(WORKERS_FILE, WORKERS_FILE_SIZE);
+
+    if(fd == -1)
+    {
+        return E_ERROR;
+    }
+
+    close(fd);
+
+    task_t tasks[WORKERS_MAX];
+    taskAttr_t attr = {20, FALSE, 0x200000};
+    uint32_t count, i;
+
+    // Throughput should grow with the tasks until the dispatcher tasks are all busy
+    for(count = 1; count <= WORKERS_MAX; count <<= 1)
+    {
+        uint64_t start = ClockTicks();
+
+        for(i = 0; i < count; i++)
+        {
+            TaskCreate(&tasks[i], &attr, WorkersTask, NULL);
+        }
+
+        for(i = 0; i < count; i++)
+        {
+            TaskJoin(tasks[i], NULL);
+        }
+
+        uint64_t ticks = ClockTicks() - start;
+
+        printf("%u tasks: %u kB/s\n", count, BenchRate((uint64_t)count * WORKERS_BYTES, ticks));
+    }
+
+    BenchUnlink(WORKERS_FILE);
+
+    return E_OK;
+}
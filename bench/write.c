@@ -0,0 +1,98 @@
+/**
+ * @file        write.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Large Write Throughput Benchmark implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <bench.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+
+/* Private types ------------------------------------------ */
+
+
+/* Private constants -------------------------------------- */
+#define WRITE_FILE          BENCH_DIR "/write"
+#define WRITE_MAX           (4 * 1024 * 1024)
+#define WRITE_BYTES         (16 * 1024 * 1024)  // Written at every size
+
+
+/* Private macros ----------------------------------------- */
+
+
+/* Private variables -------------------------------------- */
+
+static const uint32_t sizes[] = {4 * 1024, 64 * 1024, WRITE_MAX};
+
+
+/* Private function prototypes ---------------------------- */
+
+
+/* Private functions -------------------------------------- */
+
+int32_t BenchWrite(int argc, const char* argv[])
+{
+    (void)argc;
+    (void)argv;
+
+    char* buffer = (char*)malloc(WRITE_MAX);
+
+    if(buffer == NULL)
+    {
+        return E_NO_RES;
+    }
+
+    memset(buffer, 0xA5, WRITE_MAX);
+
+    // File already has the largest size so only the writes are timed
+    int32_t fd = BenchCreate(WRITE_FILE, WRITE_MAX);
+
+    if(fd == -1)
+    {
+        free(buffer);
+        return E_ERROR;
+    }
+
+    uint32_t n, i;
+    int32_t ret = E_OK;
+
+    for(n = 0; n < (sizeof(sizes) / sizeof(sizes[0])); n++)
+    {
+        uint32_t writes = WRITE_BYTES / sizes[n];
+        uint64_t start = ClockTicks();
+
+        for(i = 0; i < writes; i++)
+        {
+            lseek(fd, (off_t)((i * sizes[n]) % WRITE_MAX), SEEK_SET);
+
+            if(write(fd, buffer, sizes[n]) != (int32_t)sizes[n])
+            {
+                break;
+            }
+        }
+
+        uint64_t ticks = ClockTicks() - start;
+
+        if(i < writes)
+        {
+            printf("%u kB writes: failed after %u\n", sizes[n] / 1024, i);
+            ret = E_ERROR;
+            break;
+        }
+
+        printf("%u kB writes: %u kB/s, %u us per write\n", sizes[n] / 1024, BenchRate(WRITE_BYTES, ticks), BenchMicros(ticks) / writes);
+    }
+
+    close(fd);
+    free(buffer);
+    BenchUnlink(WRITE_FILE);
+
+    return ret;
+}
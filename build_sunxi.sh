@@ -6,7 +6,10 @@ make -C cmd/
 make -C echo/
 make -C ls/
 make -C cat/
+make -C cp/
+make -C trace/
 make -C sloader/
+make -C bench/
 make -C serial/ BOARD_CONFIG=sunxi-h3.config
 make -C timer/ BOARD_CONFIG=sunxi-h3.config
 make -C gpio/ BOARD_CONFIG=sunxi-h3.config
@@ -1,13 +1,16 @@
 #!/bin/bash
 
 make -C ../neok_lib/
-make -C proc/
+make -C proc/ CLOCK_FLAGS=-DCLOCK_GLOBAL_TIMER
 make -C cmd/
 make -C echo/
 make -C ls/
 make -C cat/
+make -C cp/
+make -C trace/
 make -C sloader/
-make -C serial/ BOARD_CONFIG=ve-a9.config
+make -C bench/ CLOCK_FLAGS=-DCLOCK_GLOBAL_TIMER
+make -C serial/ BOARD_CONFIG=ve-a9.config CLOCK_FLAGS=-DCLOCK_GLOBAL_TIMER
 make -C timer/ BOARD_CONFIG=ve-a9.config
 
 ./../rfs_generator/rfs_generator ../rfs_generator/script_ve.txt ../rfs_generator/rfs.bin
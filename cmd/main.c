@@ -10,6 +10,7 @@
 #include <errno.h>
 #include <semaphore.h>
 #include <cond.h>
+#include <proc_msg.h>
 
 #define ROUND_UP(m,a)			(((m) + ((a) - 1)) & (~((a) - 1)))
 
@@ -19,6 +20,7 @@ enum
 {
     SysInfo,
     PKill,
+    Save,
     Exit,
     Invalid
 };
@@ -30,7 +32,7 @@ static struct
     char        str[8];
     uint32_t    action;
 }commandEntries[]
-    = {{"info", SysInfo}, {"exit", Exit}, {"kill", PKill}};
+    = {{"info", SysInfo}, {"exit", Exit}, {"kill", PKill}, {"save", Save}};
 
 uint32_t CommandEntriesLookup(char *cmd)
 {
@@ -156,16 +158,12 @@ int32_t Exec(char* cmd)
 
     if(redirect == TRUE)
     {
+        // Proc files grow on write so no need to pre size the file
         int32_t r_fd = open("/proc/user/test", O_CREAT | O_RDWR);
-        if(fd == -1)
+        if(r_fd == -1)
         {
             printf("Faild to create file: /proc/user/test\n");
         }
-        if(ftruncate(r_fd, 4096) != E_OK)
-        {
-            close(fd);
-            printf("Error truncating\n");
-        }
 
         fd_count = 3;
         fd_map[0] = -1;
@@ -237,10 +235,43 @@ int32_t KillPid(char *buff)
     return E_OK;
 }
 
+// Proc keeps /proc/user in its checkpoint region only when asked to
+int32_t ProcSave(char *buff)
+{
+    (void)buff;
+
+    char* remaining = NULL;
+    int32_t fd = connect("/proc/", &remaining);
+
+    if(fd == -1)
+    {
+        printf("Proc server not found\n");
+        return E_ERROR;
+    }
+
+    io_hdr_t hdr;
+    hdr.type = _IO_INFO;
+    hdr.code = INFO_CHECKPOINT;
+    hdr.sbytes = 0;
+    hdr.rbytes = 0;
+
+    int32_t ret = MsgSend(fd, &hdr, NULL, NULL, NULL);
+
+    ConnectDetach(fd);
+
+    if(ret != E_OK)
+    {
+        printf("Failed to save /proc/user\n");
+    }
+
+    return ret;
+}
+
 int32_t (*CommandHandlers[])(char *) =
     {
         SysInfoGet,
         KillPid,
+        ProcSave,
     };
 
 key_t key;
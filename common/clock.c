@@ -0,0 +1,124 @@
+/**
+ * @file        clock.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Monotonic Clock implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <clock.h>
+#include <mman.h>
+
+
+/* Private types ------------------------------------------ */
+
+
+/* Private constants -------------------------------------- */
+#define GLOBAL_TIMER_OFFSET     (0x200)
+#define GLOBAL_TIMER_SIZE       (0x1000)
+#define GLOBAL_TIMER_LOW        (0)
+#define GLOBAL_TIMER_HIGH       (1)
+#define GLOBAL_TIMER_CONTROL    (2)
+#define GLOBAL_TIMER_EN         (0b1 << 0)
+
+
+/* Private macros ----------------------------------------- */
+
+
+/* Private variables -------------------------------------- */
+
+#ifdef CLOCK_GLOBAL_TIMER
+// Mapped by the first task reading the clock
+static volatile uint32_t* globalTimer = NULL;
+#endif
+
+
+/* Private function prototypes ---------------------------- */
+
+#ifdef CLOCK_GLOBAL_TIMER
+volatile uint32_t* ClockGlobalTimer()
+{
+    if(globalTimer != NULL)
+    {
+        return globalTimer;
+    }
+
+    // Timer belongs to the kernel and the timer driver, it is only read here
+    char* base = (char*)mmap(NULL, GLOBAL_TIMER_SIZE, (PROT_READ | PROT_NOCACHE), (MAP_PHYS | MAP_SHARED), NOFD, CLOCK_GLOBAL_TIMER_BASE);
+
+    if(base == NULL)
+    {
+        return NULL;
+    }
+
+    volatile uint32_t* timer = (volatile uint32_t*)(base + GLOBAL_TIMER_OFFSET);
+
+    // Tasks racing here keep the first mapping
+    if(!__sync_bool_compare_and_swap(&globalTimer, NULL, timer))
+    {
+        munmap(base, GLOBAL_TIMER_SIZE);
+    }
+
+    return globalTimer;
+}
+#endif
+
+
+/* Private functions -------------------------------------- */
+
+uint64_t ClockTicks()
+{
+#if defined(CLOCK_GLOBAL_TIMER)
+    volatile uint32_t* timer = ClockGlobalTimer();
+
+    // Counter is not running until whoever owns it starts it
+    if((timer == NULL) || !(timer[GLOBAL_TIMER_CONTROL] & GLOBAL_TIMER_EN))
+    {
+        return 0;
+    }
+
+    // High word is read again in case the low word wrapped in between
+    uint32_t high, low;
+    do
+    {
+        high = timer[GLOBAL_TIMER_HIGH];
+        low = timer[GLOBAL_TIMER_LOW];
+    }
+    while(high != timer[GLOBAL_TIMER_HIGH]);
+
+    return ((uint64_t)high << 32) | low;
+#elif defined(CLOCK_GENERIC_TIMER) && defined(__arm__)
+    // ARMv7 generic timer virtual count, faults unless the kernel grants user mode access in CNTKCTL
+    uint64_t ticks;
+    __asm__ volatile("isb\n\tmrrc p15, 1, %Q0, %R0, c14" : "=r"(ticks));
+    return ticks;
+#else
+    return 0;
+#endif
+}
+
+uint32_t ClockFrequency()
+{
+#if defined(CLOCK_GLOBAL_TIMER)
+    return CLOCK_GLOBAL_TIMER_HZ;
+#elif defined(CLOCK_GENERIC_TIMER) && defined(__arm__)
+    uint32_t frequency;
+    __asm__ volatile("mrc p15, 0, %0, c14, c0, 0" : "=r"(frequency));
+    return frequency;
+#else
+    return 0;
+#endif
+}
+
+uint32_t ClockMilliseconds()
+{
+    uint32_t perMs = ClockFrequency() / 1000;
+
+    if(perMs == 0)
+    {
+        return 0;
+    }
+
+    return (uint32_t)(ClockTicks() / perMs);
+}
@@ -0,0 +1,45 @@
+/**
+ * @file        clock.h
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Monotonic Clock Definition Header File
+*/
+
+#ifndef _CLOCK_H_
+#define _CLOCK_H_
+
+/* Includes ----------------------------------------------- */
+#include <types.h>
+
+
+/* Exported types ----------------------------------------- */
+
+
+/* Exported constants ------------------------------------- */
+
+// Cortex-A9 MPCore global timer, used with CLOCK_GLOBAL_TIMER on cores without the generic timer
+#ifndef CLOCK_GLOBAL_TIMER_BASE
+#define CLOCK_GLOBAL_TIMER_BASE     (0x1E000000)    // MPCore private memory region
+#endif
+
+#ifndef CLOCK_GLOBAL_TIMER_HZ
+#define CLOCK_GLOBAL_TIMER_HZ       (400000000)     // PERIPHCLK, half the 800MHz core clock
+#endif
+
+
+/* Exported macros ---------------------------------------- */
+
+
+/* Exported functions ------------------------------------- */
+
+// Free running tick count, 0 if there is no clock source or it is not running
+uint64_t ClockTicks();
+
+// Ticks per second, 0 if there is no clock source
+uint32_t ClockFrequency();
+
+// Milliseconds since the clock started
+uint32_t ClockMilliseconds();
+
+#endif
@@ -0,0 +1,210 @@
+/**
+ * @file        registry.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Server Connections Registry implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <registry.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Private types ------------------------------------------ */
+
+
+/* Private constants -------------------------------------- */
+#define REGISTRY_INITIAL_SIZE   16
+#define REGISTRY_POOL_BLOCK     32
+
+
+/* Private macros ----------------------------------------- */
+
+// Records are allocated right after the registry node
+#define REGISTRY_OBJECT(node)   ((void*)((rnode_t*)(node) + 1))
+#define REGISTRY_NODE(object)   ((rnode_t*)(object) - 1)
+
+#define REGISTRY_HASH(scoid)    ((uint32_t)(scoid) * 0x9E3779B1)
+
+
+/* Private variables -------------------------------------- */
+
+
+/* Private function prototypes ---------------------------- */
+
+int32_t RegistryGrow(registry_t* registry)
+{
+    uint32_t size = ((registry->table == NULL) ? (REGISTRY_INITIAL_SIZE) : ((registry->mask + 1) << 1));
+
+    rnode_t** table = (rnode_t**)malloc(sizeof(rnode_t*) * size);
+
+    if(table == NULL)
+    {
+        return E_ERROR;
+    }
+
+    memset(table, 0x0, sizeof(rnode_t*) * size);
+
+    // Move all records to the new table
+    if(registry->table != NULL)
+    {
+        uint32_t i;
+        for(i = 0; i <= registry->mask; i++)
+        {
+            rnode_t* node = registry->table[i];
+            while(node != NULL)
+            {
+                rnode_t* next = node->next;
+                uint32_t bucket = REGISTRY_HASH(node->scoid) & (size - 1);
+                node->next = table[bucket];
+                table[bucket] = node;
+                node = next;
+            }
+        }
+
+        free(registry->table);
+    }
+
+    registry->table = table;
+    registry->mask = size - 1;
+
+    return E_OK;
+}
+
+rnode_t* RegistryPoolGet(registry_t* registry)
+{
+    if(registry->pool == NULL)
+    {
+        // Align records to 8 bytes so any record type can be stored
+        size_t size = (sizeof(rnode_t) + registry->size + 7) & ~7;
+        char* block = (char*)malloc(size * REGISTRY_POOL_BLOCK);
+
+        if(block == NULL)
+        {
+            return NULL;
+        }
+
+        uint32_t i;
+        for(i = 0; i < REGISTRY_POOL_BLOCK; i++)
+        {
+            rnode_t* node = (rnode_t*)&block[i * size];
+            node->next = registry->pool;
+            registry->pool = node;
+        }
+    }
+
+    rnode_t* node = registry->pool;
+    registry->pool = node->next;
+
+    return node;
+}
+
+
+/* Private functions -------------------------------------- */
+
+void* RegistryInsert(registry_t* registry, int32_t scoid)
+{
+    // Nested records are not supported
+    if(RegistryFind(registry, scoid) != NULL)
+    {
+        return NULL;
+    }
+
+    // Keep load factor bellow 1
+    if((registry->table == NULL) || (registry->count > registry->mask))
+    {
+        if(RegistryGrow(registry) != E_OK && registry->table == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    rnode_t* node = RegistryPoolGet(registry);
+
+    if(node == NULL)
+    {
+        return NULL;
+    }
+
+    rnode_t** bucket = &registry->table[REGISTRY_HASH(scoid) & registry->mask];
+    node->scoid = scoid;
+    node->next = *bucket;
+    *bucket = node;
+    registry->count++;
+
+    return REGISTRY_OBJECT(node);
+}
+
+void* RegistryFind(registry_t* registry, int32_t scoid)
+{
+    if(registry->table == NULL)
+    {
+        return NULL;
+    }
+
+    rnode_t* node = registry->table[REGISTRY_HASH(scoid) & registry->mask];
+    for( ; node != NULL; node = node->next)
+    {
+        if(node->scoid == scoid)
+        {
+            return REGISTRY_OBJECT(node);
+        }
+    }
+
+    return NULL;
+}
+
+void* RegistryRemove(registry_t* registry, int32_t scoid)
+{
+    if(registry->table == NULL)
+    {
+        return NULL;
+    }
+
+    rnode_t** it = &registry->table[REGISTRY_HASH(scoid) & registry->mask];
+    for( ; *it != NULL; it = &(*it)->next)
+    {
+        if((*it)->scoid == scoid)
+        {
+            rnode_t* node = *it;
+            *it = node->next;
+            registry->count--;
+            return REGISTRY_OBJECT(node);
+        }
+    }
+
+    return NULL;
+}
+
+void RegistryRelease(registry_t* registry, void* object)
+{
+    if(object == NULL)
+    {
+        return;
+    }
+
+    // Return record to the pool
+    rnode_t* node = REGISTRY_NODE(object);
+    node->next = registry->pool;
+    registry->pool = node;
+}
+
+void RegistryForEach(registry_t* registry, void (*callBack)(void*, void*), void* arg)
+{
+    if(registry->table == NULL)
+    {
+        return;
+    }
+
+    uint32_t i;
+    for(i = 0; i <= registry->mask; i++)
+    {
+        rnode_t* node = registry->table[i];
+        for( ; node != NULL; node = node->next)
+        {
+            callBack(REGISTRY_OBJECT(node), arg);
+        }
+    }
+}
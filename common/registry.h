@@ -0,0 +1,55 @@
+/**
+ * @file        registry.h
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Server Connections Registry Definition Header File
+*/
+
+#ifndef _REGISTRY_H_
+#define _REGISTRY_H_
+
+/* Includes ----------------------------------------------- */
+#include <types.h>
+
+
+/* Exported types ----------------------------------------- */
+typedef struct RegistryNode rnode_t;
+
+struct RegistryNode
+{
+    rnode_t* next;
+    int32_t  scoid;
+};
+
+typedef struct
+{
+    rnode_t** table;
+    uint32_t  mask;
+    uint32_t  count;
+    size_t    size;
+    rnode_t*  pool;
+}registry_t;
+
+
+/* Exported constants ------------------------------------- */
+
+
+/* Exported macros ---------------------------------------- */
+
+#define REGISTRY_INITIALIZER(type)  { NULL, 0, 0, sizeof(type), NULL }
+
+
+/* Exported functions ------------------------------------- */
+
+void* RegistryInsert(registry_t* registry, int32_t scoid);
+
+void* RegistryFind(registry_t* registry, int32_t scoid);
+
+void* RegistryRemove(registry_t* registry, int32_t scoid);
+
+void RegistryRelease(registry_t* registry, void* object);
+
+void RegistryForEach(registry_t* registry, void (*callBack)(void*, void*), void* arg);
+
+#endif
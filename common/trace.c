@@ -0,0 +1,188 @@
+/**
+ * @file        trace.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Server Message Trace implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <trace.h>
+#include <clock.h>
+#include <ipc.h>
+
+
+/* Private types ------------------------------------------ */
+
+// Message being handled, found again by its rcvid when the reply is sent
+typedef struct
+{
+    uint32_t state;
+    int32_t  rcvid;
+    int32_t  scoid;
+    uint16_t type;
+    uint16_t code;
+    uint32_t sbytes;
+    uint32_t start;
+}call_t;
+
+
+/* Private constants -------------------------------------- */
+
+// More than the dispatcher tasks of any server, messages beyond it are not traced
+#define TRACE_CALLS         8
+
+// Call slot states
+#define CALL_FREE           0
+#define CALL_CLAIMED        1
+#define CALL_READY          2
+
+
+/* Private macros ----------------------------------------- */
+
+
+/* Private variables -------------------------------------- */
+
+// Header and records are dumped as they are
+static struct
+{
+    trace_hdr_t    hdr;
+    trace_record_t records[TRACE_RECORDS];
+}trace = {{TRACE_MAGIC, 0, 0, TRACE_RECORDS, sizeof(trace_record_t)}};
+
+static call_t calls[TRACE_CALLS];
+
+// Slots in use, replies skip the lookup while it is 0
+static uint32_t pending = 0;
+
+
+/* Private function prototypes ---------------------------- */
+
+static inline uint32_t TraceClock()
+{
+#if defined(TRACE_PMU) && defined(__arm__)
+    // PMU cycle counter, the kernel has to grant user mode access to it
+    uint32_t cycles;
+    __asm__ volatile("mrc p15, 0, %0, c9, c13, 0" : "=r"(cycles));
+    return cycles;
+#else
+    // Low word of the monotonic clock, the decoder works with differences
+    return (uint32_t)ClockTicks();
+#endif
+}
+
+void TraceRecord(call_t* call, int32_t status, uint32_t size)
+{
+    uint32_t end = TraceClock();
+
+    // Writers never wait for each other, each one owns the slot it reserved
+    uint32_t seq = __sync_fetch_and_add(&trace.hdr.head, 1);
+    trace_record_t* record = &trace.records[seq & (TRACE_RECORDS - 1)];
+
+    record->seq = 0;
+    __sync_synchronize();
+
+    record->time = call->start;
+    record->duration = end - call->start;
+    record->rcvid = call->rcvid;
+    record->scoid = call->scoid;
+    record->status = status;
+    record->bytes = call->sbytes + size;
+    record->type = call->type;
+    record->code = call->code;
+
+    __sync_synchronize();
+    record->seq = seq + 1;
+}
+
+
+/* Private functions -------------------------------------- */
+
+void TraceBegin(int32_t rcvid, int32_t scoid, io_hdr_t* hdr)
+{
+    if(!trace.hdr.enabled)
+    {
+        return;
+    }
+
+    uint32_t i;
+    for(i = 0; i < TRACE_CALLS; i++)
+    {
+        if(__sync_bool_compare_and_swap(&calls[i].state, CALL_FREE, CALL_CLAIMED))
+        {
+            __sync_fetch_and_add(&pending, 1);
+
+            calls[i].rcvid = rcvid;
+            calls[i].scoid = scoid;
+            calls[i].type = hdr->type;
+            calls[i].code = hdr->code;
+            calls[i].sbytes = hdr->sbytes;
+            calls[i].start = TraceClock();
+
+            // Slot is only matched once it is complete
+            __sync_synchronize();
+            calls[i].state = CALL_READY;
+            return;
+        }
+    }
+}
+
+void TraceEnd(int32_t rcvid, int32_t status, uint32_t size)
+{
+    if(pending == 0)
+    {
+        return;
+    }
+
+    uint32_t i;
+    for(i = 0; i < TRACE_CALLS; i++)
+    {
+        if((calls[i].state == CALL_READY) && (calls[i].rcvid == rcvid))
+        {
+            // Messages in flight when tracing is turned off are dropped
+            if(trace.hdr.enabled)
+            {
+                TraceRecord(&calls[i], status, size);
+            }
+
+            __sync_fetch_and_sub(&pending, 1);
+            __sync_synchronize();
+            calls[i].state = CALL_FREE;
+            return;
+        }
+    }
+}
+
+int32_t TraceRespond(int32_t rcvid, int32_t status, const char* buffer, uint32_t size)
+{
+    TraceEnd(rcvid, status, size);
+
+    return MsgRespond(rcvid, status, buffer, size);
+}
+
+int32_t TraceControl(uint16_t code, const char** data, uint32_t* size)
+{
+    uint32_t max = *size;
+
+    *data = NULL;
+    *size = 0;
+
+    switch(code)
+    {
+    case TRACE_INFO_ON:
+        trace.hdr.enabled = 1;
+        break;
+    case TRACE_INFO_OFF:
+        trace.hdr.enabled = 0;
+        break;
+    case TRACE_INFO_DUMP:
+        // Records written during the copy are told apart by their sequence number
+        *data = (const char*)&trace;
+        *size = ((max < sizeof(trace)) ? (max) : (sizeof(trace)));
+        break;
+    default:
+        return E_INVAL;
+    }
+
+    return E_OK;
+}
@@ -0,0 +1,68 @@
+/**
+ * @file        trace.h
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Server Message Trace Definition Header File
+*/
+
+#ifndef _TRACE_H_
+#define _TRACE_H_
+
+/* Includes ----------------------------------------------- */
+#include <types.h>
+#include <io_types.h>
+
+
+/* Exported types ----------------------------------------- */
+
+// One handled message, seq is 0 while the record is being written
+typedef struct
+{
+    uint32_t seq;
+    uint32_t time;
+    uint32_t duration;
+    int32_t  rcvid;
+    int32_t  scoid;
+    int32_t  status;
+    uint32_t bytes;
+    uint16_t type;
+    uint16_t code;
+}trace_record_t;
+
+// Dump header, followed by the ring records
+typedef struct
+{
+    uint32_t magic;
+    uint32_t head;
+    uint32_t enabled;
+    uint16_t records;
+    uint16_t size;
+}trace_hdr_t;
+
+
+/* Exported constants ------------------------------------- */
+#define TRACE_MAGIC         0x54524345
+#define TRACE_RECORDS       256
+
+// Info codes answered by every traced server
+#define TRACE_INFO_DUMP     0x200
+#define TRACE_INFO_ON       0x201
+#define TRACE_INFO_OFF      0x202
+
+
+/* Exported macros ---------------------------------------- */
+#define TRACE_INFO(code)    (((code) & 0xFF00) == 0x200)
+
+
+/* Exported functions ------------------------------------- */
+
+void TraceBegin(int32_t rcvid, int32_t scoid, io_hdr_t* hdr);
+
+void TraceEnd(int32_t rcvid, int32_t status, uint32_t size);
+
+int32_t TraceRespond(int32_t rcvid, int32_t status, const char* buffer, uint32_t size);
+
+int32_t TraceControl(uint16_t code, const char** data, uint32_t* size);
+
+#endif
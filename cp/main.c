@@ -0,0 +1,133 @@
+#include <types.h>
+#include <io_types.h>
+#include <server.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <proc_msg.h>
+
+
+int32_t CpClone(const char* src, const char* dst)
+{
+    char* srcRemaining = NULL;
+    char* dstRemaining = NULL;
+
+    int32_t fd = connect(src, &srcRemaining);
+
+    if(fd == -1)
+    {
+        return E_ERROR;
+    }
+
+    int32_t dstFd = connect(dst, &dstRemaining);
+
+    if(dstFd == -1)
+    {
+        ConnectDetach(fd);
+        return E_ERROR;
+    }
+
+    ConnectDetach(dstFd);
+
+    // Both paths have to be served by the same server
+    uint32_t prefix = srcRemaining - src;
+
+    if((prefix != (uint32_t)(dstRemaining - dst)) || strncmp(src, dst, prefix))
+    {
+        ConnectDetach(fd);
+        return E_ERROR;
+    }
+
+    // Request holds the source path followed by the new path
+    char request[256];
+    uint32_t srcLen = strlen(srcRemaining) + 1;
+    uint32_t dstLen = strlen(dstRemaining) + 1;
+
+    if((srcLen + dstLen) > sizeof(request))
+    {
+        ConnectDetach(fd);
+        return E_INVAL;
+    }
+
+    memcpy(request, srcRemaining, srcLen);
+    memcpy(&request[srcLen], dstRemaining, dstLen);
+
+    // Message header
+    io_hdr_t hdr;
+    hdr.type = _IO_INFO;
+    hdr.code = INFO_CLONE;
+    hdr.sbytes = srcLen + dstLen;
+    hdr.rbytes = 0;
+    uint32_t replySize;
+
+    int32_t ret = MsgSend(fd, &hdr, request, NULL, &replySize);
+
+    ConnectDetach(fd);
+
+    return ret;
+}
+
+int32_t CpCopy(const char* src, const char* dst)
+{
+    int32_t in = open(src, O_RDONLY);
+
+    if(in == -1)
+    {
+        printf("File %s not found\n", src);
+        return E_INVAL;
+    }
+
+    int32_t out = open(dst, O_WRONLY | O_CREAT);
+
+    if(out == -1)
+    {
+        printf("File %s cannot be created\n", dst);
+        close(in);
+        return E_INVAL;
+    }
+
+    // Existing destination may be longer than the source, its old tail must not survive
+    if(ftruncate(out, 0) != E_OK)
+    {
+        printf("File %s cannot be truncated\n", dst);
+        close(in);
+        close(out);
+        return E_ERROR;
+    }
+
+    char buffer[512];
+    int32_t size;
+
+    while((size = read(in, buffer, sizeof(buffer))) > 0)
+    {
+        if(write(out, buffer, size) != size)
+        {
+            close(in);
+            close(out);
+            return E_ERROR;
+        }
+    }
+
+    close(in);
+    close(out);
+
+    return E_OK;
+}
+
+int main(int argc, const char* argv[])
+{
+    if(argc != 3)
+    {
+        printf("Usage: cp source destination\n");
+        return E_INVAL;
+    }
+
+    // Files on the same server are cloned without moving data, anything else is copied
+    if(CpClone(argv[1], argv[2]) == E_OK)
+    {
+        return E_OK;
+    }
+
+    return CpCopy(argv[1], argv[2]);
+}
@@ -15,6 +15,8 @@
 #include <fcntl.h>
 #include <string.h>
 #include <gpio.h>
+#include <registry.h>
+#include <trace.h>
 
 /* Constants ---------------------------------------------- */
 #define GPIO_PATH           "/dev/gpio"
@@ -25,9 +27,8 @@
 
 
 /* Types -------------------------------------------------- */
-typedef struct Client
+typedef struct
 {
-    struct Client *next, *prev;
     int32_t scoid;
     int32_t pin;
     int32_t access;
@@ -36,22 +37,19 @@ typedef struct Client
 
 /* Macros ------------------------------------------------- */
 
+// Every reply closes the trace record of the message being handled
+#define MsgRespond(rcvid, status, buffer, size)     TraceRespond(rcvid, status, buffer, size)
+
 
 /* Variables ---------------------------------------------- */
-static struct
-{
-    client_t *first;
-    client_t *last;
-}clients;
+static registry_t clients = REGISTRY_INITIALIZER(client_t);
 
 
 /* Functions prototypes------------------------------------ */
 
 client_t* Client(int32_t scoid);
 
-void ClientInsert(client_t* client);
-
-void ClientRemove(client_t* client);
+void ClientRemove(int32_t scoid);
 
 client_t* ClientFind(int32_t scoid);
 
@@ -59,6 +57,8 @@ int32_t GpioConnect(notify_t* info);
 
 int32_t GpioDisconnect(notify_t* info);
 
+int32_t GpioInfo(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uint32_t offset);
+
 int32_t GpioOpen(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uint32_t offset);
 
 int32_t GpioClose(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uint32_t offset);
@@ -72,62 +72,67 @@ int32_t GpioWrite(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uin
 
 client_t* Client(int32_t scoid)
 {
-    client_t *client = (client_t*)malloc(sizeof(client_t));
+    client_t *client = (client_t*)RegistryInsert(&clients, scoid);
+
+    if(client == NULL)
+    {
+        return NULL;
+    }
+
     client->scoid = scoid;
     client->pin = GPIO_PIN_INVALID;
     client->access = GPIO_ACCESS_INVALID;
     return client;
 }
 
-void ClientInsert(client_t* client)
+void ClientRemove(int32_t scoid)
 {
-    client->next = clients.first;
-    clients.first = client;
-    client->prev = NULL;
-    if(clients.last == NULL) clients.last = client;
+    RegistryRelease(&clients, RegistryRemove(&clients, scoid));
 }
 
-void ClientRemove(client_t* client)
+client_t* ClientFind(int32_t scoid)
 {
-    if(client == NULL) return;
-
-    if(client == clients.first) clients.first = client->next;
-    else client->prev->next = client->next;
-    
-    if(client == clients.last) clients.last = client->prev;
-    else client->next->prev = client->prev;
-
-    free(client);
+    return (client_t*)RegistryFind(&clients, scoid);
 }
 
-client_t* ClientFind(int32_t scoid)
+int32_t GpioConnect(notify_t* info)
 {
-    client_t* client = clients.first;
-    for( ; client != NULL; client = client->next)
+    if(Client(info->scoid) == NULL)
     {
-        if((client->scoid == scoid))
-        {
-            return client;
-        }
+        return E_BUSY;
     }
-    return NULL;
-}
 
-int32_t GpioConnect(notify_t* info)
-{
-    ClientInsert(Client(info->scoid));
     return E_OK;
 }
 
 int32_t GpioDisconnect(notify_t* info)
 {
-    ClientRemove(ClientFind(info->scoid));
+    ClientRemove(info->scoid);
 
     return E_OK;
 }
 
+int32_t GpioInfo(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uint32_t offset)
+{
+    TraceBegin(rcvid, scoid, hdr);
+
+    // Only the message trace is exposed
+    if(!TRACE_INFO(hdr->code))
+    {
+        return MsgRespond(rcvid, E_INVAL, NULL, 0);
+    }
+
+    const char* data;
+    uint32_t size = hdr->rbytes;
+    int32_t ret = TraceControl(hdr->code, &data, &size);
+
+    return MsgRespond(rcvid, ret, data, size);
+}
+
 int32_t GpioOpen(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uint32_t offset)
 {
+    TraceBegin(rcvid, scoid, hdr);
+
     client_t* client = ClientFind(scoid);
 
     // This use case should never happen
@@ -182,6 +187,8 @@ int32_t GpioOpen(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uint
 
 int32_t GpioClose(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uint32_t offset)
 {
+    TraceBegin(rcvid, scoid, hdr);
+
     client_t* client = ClientFind(scoid);
 
     // This use case should never happen
@@ -199,6 +206,8 @@ int32_t GpioClose(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uin
 
 int32_t GpioRead(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uint32_t offset)
 {
+    TraceBegin(rcvid, scoid, hdr);
+
     client_t* client = ClientFind(scoid);
 
     // This use case should never happen
@@ -223,6 +232,8 @@ int32_t GpioRead(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uint
 
 int32_t GpioWrite(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uint32_t offset)
 {
+    TraceBegin(rcvid, scoid, hdr);
+
     client_t* client = ClientFind(scoid);
 
     // This use case should never happen
@@ -268,7 +279,7 @@ int main(int argc, const char* argv[])
     // Install Server Dispatcher to handle client messages
     dispatch_attr_t attr = {0x0, 5, 4, 1};
     ctrl_funcs_t gpio_ctrl_funcs = { GpioConnect, GpioDisconnect, NULL };
-    io_funcs_t gpio_io_funcs = { NULL, GpioRead, GpioWrite, GpioOpen, GpioClose,
+    io_funcs_t gpio_io_funcs = { GpioInfo, GpioRead, GpioWrite, GpioOpen, GpioClose,
                                  NULL, NULL,     NULL,      NULL,     NULL};
     dispatch_t* gpio_disp = DispatcherAttach(GPIO_PATH, &attr, &gpio_io_funcs, &gpio_ctrl_funcs);
 
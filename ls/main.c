@@ -5,6 +5,7 @@
 #include <string.h>
 #include <fcntl.h>
 #include <unistd.h>
+#include <proc_msg.h>
 
 int LsNamespace(const char* path)
 {
@@ -61,47 +62,119 @@ int LsNamespace(const char* path)
     return E_ERROR;
 }
 
-int32_t LsServer(int32_t fd, const char* path)
+int32_t LsEntries(const char* entries, uint32_t size)
+{
+    uint32_t offset = 0;
+    while(offset < size)
+    {
+        io_entry_t *entry = (io_entry_t *)&entries[offset];
+
+        if(entry->type == INFO_DIR)
+        {
+            dentry_t *dir = &entry->dir;
+            printf("%s/\n", dir->name);
+            offset += (sizeof(dentry_t) + dir->len - 3);
+        }
+        else if(entry->type == INFO_FILE)
+        {
+            fentry_t *file = &entry->file;
+            printf("%s\n", file->name);
+            offset += (sizeof(fentry_t) + file->len - 3);
+        }
+        else
+        {
+            return E_ERROR;
+        }
+    }
+
+    return E_OK;
+}
+
+// Servers without paged listings, such as rfs, answer the whole directory in one reply
+int32_t LsServerAll(int32_t fd, const char* path)
 {
     // Reply buffer
-    char reply[256];
+    char reply[512];
     // Message header
     io_hdr_t hdr;
     hdr.type = _IO_INFO;
     hdr.code = INFO_LIST_ALL;
     hdr.sbytes = strlen(path) + 1;
-    hdr.rbytes = sizeof(reply) - 1;
+    hdr.rbytes = sizeof(reply);
     uint32_t replySize;
 
-    if(MsgSend(fd, &hdr, path, reply, &replySize) == E_OK)
+    if(MsgSend(fd, &hdr, path, reply, &replySize) != E_OK)
     {
-        uint32_t offset = 0;
-        while(offset < replySize)
+        return E_ERROR;
+    }
+
+    return LsEntries(reply, replySize);
+}
+
+int32_t LsServer(int32_t fd, const char* path)
+{
+    // Request holds the listing cursor followed by the path
+    char request[sizeof(list_cursor_t) + 256];
+    // Reply buffer
+    char reply[512];
+    uint32_t len = strlen(path) + 1;
+
+    if(len > (sizeof(request) - sizeof(list_cursor_t)))
+    {
+        return E_INVAL;
+    }
+
+    memcpy(&request[sizeof(list_cursor_t)], path, len);
+
+    // Message header
+    io_hdr_t hdr;
+    hdr.type = _IO_INFO;
+    hdr.code = INFO_LIST_PAGE;
+    hdr.sbytes = sizeof(list_cursor_t) + len;
+    hdr.rbytes = sizeof(reply);
+    uint32_t replySize;
+
+    // Large directories are listed one page at a time
+    list_cursor_t cursor = LIST_CURSOR_INITIALIZER;
+    uint32_t first = TRUE;
+
+    while(cursor.phase != LIST_CURSOR_END)
+    {
+        memcpy(request, &cursor, sizeof(list_cursor_t));
+
+        int32_t ret = MsgSend(fd, &hdr, request, reply, &replySize);
+
+        // Server does not know paged listings
+        if(first && (ret == E_INVAL))
         {
-            io_entry_t *entry = (io_entry_t *)&reply[offset];
+            return LsServerAll(fd, path);
+        }
 
-            if(entry->type == INFO_DIR)
-            {
-                dentry_t *dir = &entry->dir;
-                printf("%s/\n", dir->name);
-                offset += (sizeof(dentry_t) + dir->len - 3);
-            }
-            else if(entry->type == INFO_FILE)
-            {
-                fentry_t *file = &entry->file;
-                printf("%s\n", file->name);
-                offset += (sizeof(fentry_t) + file->len - 3);
-            }
-            else
-            {
-                return E_ERROR;
-            }   
+        if(ret != E_OK)
+        {
+            return E_ERROR;
         }
 
-        return E_OK;
+        first = FALSE;
+
+        list_page_t* page = (list_page_t*)reply;
+
+        if(LsEntries(&reply[sizeof(list_page_t)], page->size) != E_OK)
+        {
+            return E_ERROR;
+        }
+
+        // Nothing fitted in the reply
+        if((page->size == 0) && (page->next.phase != LIST_CURSOR_END) &&
+           (page->next.seq == cursor.seq) && (page->next.phase == cursor.phase))
+        {
+            return E_ERROR;
+        }
+
+        cursor = page->next;
     }
 
-    return E_ERROR;
+    return E_OK;
 }
 
 int32_t Ls(const char* path)
@@ -0,0 +1,396 @@
+/**
+ * @file        checkpoint.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Proc File System Checkpoint implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <checkpoint.h>
+#include <mman.h>
+#include <string.h>
+
+
+/* Private types ------------------------------------------ */
+
+// Image layout follows the RFS one, offsets are relative to the header
+typedef struct
+{
+    uint32_t type;
+    size_t   size;
+    uint32_t files_off;
+    uint32_t files_count;
+    uint32_t names_off;
+    uint32_t names_size;
+    uint32_t data_off;
+}ckpt_header_t;
+
+typedef struct
+{
+    size_t   size;
+    uint32_t data_off;
+    uint32_t name_off;
+    uint16_t access;
+    uint16_t permission;
+    uint32_t kind;          // Plain file, FIFO or circular log
+}ckpt_file_t;
+
+// Image size computed before anything is written
+typedef struct
+{
+    uint32_t files;
+    uint32_t names;
+    size_t   data;
+}ckpt_size_t;
+
+
+/* Private constants -------------------------------------- */
+// Changes with the image layout so an older image is not misread
+#define CKPT_TYPE           0xCACFC0DF
+#define CKPT_PAGE_SIZE      4096
+#define CKPT_PATH_SIZE      256
+
+// File kinds, FIFO and log contents are streamed and not saved
+#define CKPT_FILE           0
+#define CKPT_FIFO           1
+#define CKPT_LOG            2
+
+
+/* Private macros ----------------------------------------- */
+#define ALIGN_UP(m,a)	(((m) + (a - 1)) & (~(a - 1)))
+
+
+/* Private variables -------------------------------------- */
+
+static struct
+{
+    ckpt_header_t* hdr;
+    size_t         size;
+    uint32_t       live;    // Image data still referenced by extents
+}Ckpt;
+
+
+/* Private function prototypes ---------------------------- */
+
+// Files stay read locked until CheckpointUnlock so their sizes hold until they are written
+void CheckpointMeasure(dir_t* dir, uint32_t len, ckpt_size_t* size)
+{
+    file_t* file = dir->files;
+    for( ; file != NULL; file = file->sibling)
+    {
+        RwLockRead(&file->lock);
+
+        size->files++;
+        size->names += len + 1 + file->len + 1;
+        size->data += ALIGN_UP(file->size, CKPT_PAGE_SIZE);
+    }
+
+    dir_t* child = dir->dirs;
+    for( ; child != NULL; child = child->sibling)
+    {
+        CheckpointMeasure(child, len + 1 + child->len, size);
+    }
+}
+
+void CheckpointUnlock(dir_t* dir)
+{
+    file_t* file = dir->files;
+    for( ; file != NULL; file = file->sibling)
+    {
+        RwLockUnlock(&file->lock);
+    }
+
+    dir_t* child = dir->dirs;
+    for( ; child != NULL; child = child->sibling)
+    {
+        CheckpointUnlock(child);
+    }
+}
+
+int32_t CheckpointDetach(dir_t* dir)
+{
+    file_t* file = dir->files;
+    for( ; file != NULL; file = file->sibling)
+    {
+        // Boot image and shared data stay where they are
+        RwLockWrite(&file->lock);
+        int32_t ret = ExtentsDetach(&file->extents, EXTENT_CKPT);
+        RwLockUnlock(&file->lock);
+
+        if(ret != E_OK)
+        {
+            return ret;
+        }
+    }
+
+    dir_t* child = dir->dirs;
+    for( ; child != NULL; child = child->sibling)
+    {
+        if(CheckpointDetach(child) != E_OK)
+        {
+            return E_NO_RES;
+        }
+    }
+
+    return E_OK;
+}
+
+int32_t CheckpointWrite(dir_t* dir, char* path, uint32_t len, ckpt_size_t* pos)
+{
+    char* image = (char*)Ckpt.hdr;
+    ckpt_file_t* files = (ckpt_file_t*)&image[Ckpt.hdr->files_off];
+
+    file_t* file = dir->files;
+    for( ; file != NULL; file = file->sibling)
+    {
+        if((len + 1 + file->len) >= CKPT_PATH_SIZE)
+        {
+            return E_INVAL;
+        }
+
+        ckpt_file_t* entry = &files[pos->files++];
+        char* name = &image[Ckpt.hdr->names_off + pos->names];
+
+        memcpy(name, path, len);
+        name[len] = '/';
+        memcpy(&name[len + 1], file->name, file->len);
+        name[len + 1 + file->len] = 0;
+
+        entry->size = file->size;
+        entry->data_off = Ckpt.hdr->data_off + pos->data;
+        entry->name_off = pos->names;
+        entry->access = file->access;
+        entry->permission = file->permission;
+        entry->kind = ((file->fifo != NULL) ? (CKPT_FIFO) : ((file->log != NULL) ? (CKPT_LOG) : (CKPT_FILE)));
+
+        ExtentsRead(&file->extents, 0, &image[entry->data_off], file->size);
+
+        pos->names += len + 1 + file->len + 1;
+        pos->data += ALIGN_UP(file->size, CKPT_PAGE_SIZE);
+    }
+
+    dir_t* child = dir->dirs;
+    for( ; child != NULL; child = child->sibling)
+    {
+        if((len + 1 + child->len) >= CKPT_PATH_SIZE)
+        {
+            return E_INVAL;
+        }
+
+        path[len] = '/';
+        memcpy(&path[len + 1], child->name, child->len);
+
+        int32_t ret = CheckpointWrite(child, path, len + 1 + child->len, pos);
+
+        if(ret != E_OK)
+        {
+            return ret;
+        }
+    }
+
+    return E_OK;
+}
+
+uint32_t CheckpointTerminated(const char* name, uint32_t size)
+{
+    uint32_t i;
+    for(i = 0; i < size; i++)
+    {
+        if(name[i] == 0)
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+// Lays out the image for the measured size and fills it, a NULL dir saves an empty image
+int32_t CheckpointWriteImage(dir_t* dir, ckpt_size_t* size)
+{
+    uint32_t filesOff = ALIGN_UP(sizeof(ckpt_header_t), 8);
+    uint32_t namesOff = filesOff + size->files * sizeof(ckpt_file_t);
+    uint32_t dataOff = ALIGN_UP(namesOff + size->names, CKPT_PAGE_SIZE);
+
+    if((dataOff + size->data) > Ckpt.size)
+    {
+        return E_NO_RES;
+    }
+
+    // Image is only valid once the type is written back at the end
+    Ckpt.hdr->type = 0;
+    Ckpt.hdr->size = dataOff + size->data;
+    Ckpt.hdr->files_off = filesOff;
+    Ckpt.hdr->files_count = size->files;
+    Ckpt.hdr->names_off = namesOff;
+    Ckpt.hdr->names_size = size->names;
+    Ckpt.hdr->data_off = dataOff;
+
+    if(dir != NULL)
+    {
+        char path[CKPT_PATH_SIZE];
+        ckpt_size_t pos = {0, 0, 0};
+        uint32_t len = strlen(CHECKPOINT_PATH);
+
+        memcpy(path, CHECKPOINT_PATH, len);
+
+        int32_t ret = CheckpointWrite(dir, path, len, &pos);
+
+        if(ret != E_OK)
+        {
+            return ret;
+        }
+    }
+
+    // Contents have to reach memory before the image is marked valid
+    __sync_synchronize();
+
+    Ckpt.hdr->type = CKPT_TYPE;
+
+    return E_OK;
+}
+
+
+/* Private functions -------------------------------------- */
+
+int32_t CheckpointInit(void* addr, size_t size)
+{
+    if((Ckpt.hdr != NULL) || (size < CKPT_PAGE_SIZE))
+    {
+        return E_INVAL;
+    }
+
+    // Reserved memory outlives the server, its contents are what the previous instance saved
+    Ckpt.hdr = (ckpt_header_t*)mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PHYS | MAP_SHARED, NOFD, (uint32_t)addr);
+
+    if(Ckpt.hdr == NULL)
+    {
+        return E_ERROR;
+    }
+
+    Ckpt.size = size;
+
+    return E_OK;
+}
+
+int32_t CheckpointRestore()
+{
+    if(Ckpt.hdr == NULL)
+    {
+        return E_INVAL;
+    }
+
+    ckpt_header_t* hdr = Ckpt.hdr;
+
+    // Nothing saved yet or a save was interrupted, ranges are checked without overflowing
+    if((hdr->type != CKPT_TYPE) || (hdr->size > Ckpt.size) ||
+       (hdr->names_off > hdr->size) || (hdr->names_size > (hdr->size - hdr->names_off)) ||
+       (hdr->files_off > hdr->size) || (hdr->files_count > ((hdr->size - hdr->files_off) / sizeof(ckpt_file_t))))
+    {
+        return E_NO_RES;
+    }
+
+    char* image = (char*)hdr;
+    ckpt_file_t* files = (ckpt_file_t*)&image[hdr->files_off];
+
+    // Only file records are created, data stays in the image until a file is written
+    uint32_t i;
+    for(i = 0; i < hdr->files_count; i++)
+    {
+        ckpt_file_t* entry = &files[i];
+
+        if((entry->name_off >= hdr->names_size) || (entry->data_off > hdr->size) || (entry->size > (hdr->size - entry->data_off)))
+        {
+            return E_ERROR;
+        }
+
+        const char* path = &image[hdr->names_off + entry->name_off];
+
+        // Names have to end inside the names area
+        if(!CheckpointTerminated(path, hdr->names_size - entry->name_off))
+        {
+            return E_ERROR;
+        }
+        void* data = ((entry->size > 0) ? (&image[entry->data_off]) : (NULL));
+
+        file_t* file = ProcFileCreate(NULL, path, data, entry->size, EXTENT_CKPT, entry->access, entry->permission);
+
+        if(file == NULL)
+        {
+            return E_ERROR;
+        }
+
+        // FIFOs and logs come back empty
+        if(entry->kind == CKPT_FIFO)
+        {
+            file->fifo = FifoCreate();
+        }
+        else if(entry->kind == CKPT_LOG)
+        {
+            file->log = LogRingCreate();
+        }
+
+        if(((entry->kind == CKPT_FIFO) && (file->fifo == NULL)) || ((entry->kind == CKPT_LOG) && (file->log == NULL)))
+        {
+            return E_NO_RES;
+        }
+
+        if(data != NULL)
+        {
+            Ckpt.live++;
+        }
+    }
+
+    return E_OK;
+}
+
+int32_t CheckpointSave(dir_t* dir)
+{
+    if(Ckpt.hdr == NULL)
+    {
+        return E_NO_RES;
+    }
+
+    // Files still served from the previous image get their own copy before it is overwritten
+    if(Ckpt.live > 0)
+    {
+        char* remaining;
+        CheckpointDetach(ProcPathResolve(NULL, NULL, &remaining));
+    }
+
+    // Unlinked files that are still open keep the image busy
+    if(Ckpt.live > 0)
+    {
+        return E_BUSY;
+    }
+
+    ckpt_size_t size = {0, 0, 0};
+
+    if(dir == NULL)
+    {
+        return CheckpointWriteImage(NULL, &size);
+    }
+
+    CheckpointMeasure(dir, strlen(CHECKPOINT_PATH), &size);
+
+    int32_t ret = CheckpointWriteImage(dir, &size);
+
+    CheckpointUnlock(dir);
+
+    return ret;
+}
+
+int32_t CheckpointRelease(void* addr, size_t size)
+{
+    char* start = (char*)addr;
+
+    if((Ckpt.hdr == NULL) || (start < (char*)Ckpt.hdr) || ((start + size) > ((char*)Ckpt.hdr + Ckpt.size)))
+    {
+        return E_INVAL;
+    }
+
+    __sync_sub_and_fetch(&Ckpt.live, 1);
+
+    return E_OK;
+}
@@ -0,0 +1,42 @@
+/**
+ * @file        checkpoint.h
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Proc File System Checkpoint Definition Header File
+*/
+
+#ifndef _CHECKPOINT_H_
+#define _CHECKPOINT_H_
+
+/* Includes ----------------------------------------------- */
+#include <types.h>
+#include <proc.h>
+
+
+/* Exported types ----------------------------------------- */
+
+
+/* Exported constants ------------------------------------- */
+
+// Name of the reserved memory region in the RFS devices list
+#define CHECKPOINT_DEVICE   "ckpt"
+
+// Subtree kept across server restarts
+#define CHECKPOINT_PATH     "/user"
+
+
+/* Exported macros ---------------------------------------- */
+
+
+/* Exported functions ------------------------------------- */
+
+int32_t CheckpointInit(void* addr, size_t size);
+
+int32_t CheckpointRestore();
+
+int32_t CheckpointSave(dir_t* dir);
+
+int32_t CheckpointRelease(void* addr, size_t size);
+
+#endif
@@ -8,8 +8,10 @@
 
 /* Includes ----------------------------------------------- */
 #include <connection.h>
+#include <registry.h>
 #include <vector.h>
 #include <stdlib.h>
+#include <string.h>
 
 
 /* Private types ------------------------------------------ */
@@ -34,7 +36,8 @@ typedef struct
 static cvector_vector_type(listener_t*) listeners = NULL;
 #endif
 
-static cvector_vector_type(connect_t*) connections = NULL;
+static registry_t connections = REGISTRY_INITIALIZER(connect_t);
+static mutex_t registryLock = MUTEX_INITIALIZER;
 static void (*CloseCallBack)(connect_t*) = NULL;
 
 /* Private function prototypes ---------------------------- */
@@ -57,20 +60,37 @@ int32_t ConnectionListenerGet(int32_t chid)
 }
 #endif
 
-int32_t ConnectionFind(int32_t scoid)
+// Runs once the connection is detached and no request uses it anymore
+void ConnectionFree(connect_t* connect)
 {
-    if (connections)
+    // Do we need to close the connection
+    if((connect->state != CONNECTION_CLOSE) && (CloseCallBack != NULL))
     {
-        size_t i;
-		for (i = 0; i < cvector_size(connections); ++i)
+        CloseCallBack(connect);
+    }
+
+    // Extra handles are closed and released with the connection
+    uint32_t i;
+    for(i = 0; i < (CONNECTION_HANDLES - 1); i++)
+    {
+        connect_t* handle = connect->handles[i];
+
+        if(handle == NULL)
         {
-            if(connections[i]->scoid == scoid)
-            {
-                return (int32_t)i;
-            }
+            continue;
         }
-	}
-    return -1;
+
+        if((handle->state != CONNECTION_CLOSE) && (CloseCallBack != NULL))
+        {
+            CloseCallBack(handle);
+        }
+
+        free(handle);
+    }
+
+    MutexLock(&registryLock);
+    RegistryRelease(&connections, connect);
+    MutexUnlock(&registryLock);
 }
 
 /* Private functions -------------------------------------- */
@@ -134,66 +154,159 @@ int32_t ConnectionSetCloseCallBack(void (*callBack)(connect_t*))
 
 int32_t ConnectionAttach(notify_t* info)
 {
-    // Check if there is a connection for this scoid
-    int32_t index = ConnectionFind(info->scoid);
+    MutexLock(&registryLock);
 
     // Nested connection are not supported
-    if(index != -1)
+    connect_t* connect = (connect_t*)RegistryInsert(&connections, info->scoid);
+
+    if(connect == NULL)
     {
+        MutexUnlock(&registryLock);
         return E_BUSY;
     }
 
-    connect_t* connect = (connect_t*)malloc(sizeof(connect_t));
     connect->scoid = info->scoid;
+    connect->handle = 0;
     connect->state = CONNECTION_CLOSE;
     connect->access = O_RDONLY;
+    connect->flags = 0;
     connect->seek = 0;
     connect->handler = NULL;
+    connect->ring = NULL;
+    MutexInit(&connect->lock);
+    connect->refs = 1;
+#ifdef PROC_STATS
+    connect->ops = 0;
+    connect->bytes = 0;
+#endif
+    memset(connect->handles, 0, sizeof(connect->handles));
 
-    // Register connection
-    cvector_push_back(connections, connect);
+    MutexUnlock(&registryLock);
 
     return E_OK;
 }
 
 int32_t ConnectionDetach(notify_t* info)
 {
-    // Find connection for this scoid
-    int32_t index = ConnectionFind(info->scoid);
+    // Find connection for this scoid, requests already holding it keep it until they are done
+    MutexLock(&registryLock);
+    connect_t* connect = (connect_t*)RegistryRemove(&connections, info->scoid);
+    MutexUnlock(&registryLock);
 
     // Connection not found???
-    if(index == -1)
+    if(connect == NULL)
     {
         return E_ERROR;
     }
 
-    connect_t* connect = connections[index];
+    // Drop the registry reference
+    ConnectionPut(connect);
 
-    cvector_erase(connections, index);
+    return E_OK;
+}
 
-    // Do we need to close the connection
-    if((connect->state != CONNECTION_CLOSE) && (CloseCallBack != NULL))
+void ConnectionForEach(void (*callBack)(connect_t*, void*), void* arg)
+{
+    MutexLock(&registryLock);
+    RegistryForEach(&connections, (void (*)(void*, void*))callBack, arg);
+    MutexUnlock(&registryLock);
+}
+
+connect_t* ConnectionGet(int32_t scoid)
+{
+    // Find connection for this scoid
+    MutexLock(&registryLock);
+    connect_t* connect = (connect_t*)RegistryFind(&connections, scoid);
+
+    if(connect != NULL)
     {
-        CloseCallBack(connect);
+        connect->refs++;
     }
 
-    free(connect);
+    MutexUnlock(&registryLock);
 
-    return E_OK;
+    return connect;
 }
 
-connect_t* ConnectionGet(int32_t scoid)
+void ConnectionPut(connect_t* con)
 {
-    // Find connection for this scoid
-    int32_t index = ConnectionFind(scoid);
+    if(con == NULL)
+    {
+        return;
+    }
 
-    // Connection not found
-    if(index == -1)
+    MutexLock(&registryLock);
+    uint32_t refs = --con->refs;
+    MutexUnlock(&registryLock);
+
+    if(refs == 0)
+    {
+        ConnectionFree(con);
+    }
+}
+
+connect_t* ConnectionHandle(connect_t* con, uint32_t handle)
+{
+    if((con == NULL) || (handle >= CONNECTION_HANDLES))
     {
         return NULL;
     }
 
-    return connections[index];
+    return ((handle == 0) ? (con) : (con->handles[handle - 1]));
+}
+
+connect_t* ConnectionHandleAlloc(connect_t* con)
+{
+    // Handle 0 keeps single file clients working unchanged
+    if(con->state == CONNECTION_CLOSE)
+    {
+        return con;
+    }
+
+    uint32_t i;
+    for(i = 0; i < (CONNECTION_HANDLES - 1); i++)
+    {
+        connect_t* handle = con->handles[i];
+
+        // Closed handles are reused, they are only released on detach
+        if(handle != NULL)
+        {
+            if(handle->state == CONNECTION_CLOSE)
+            {
+                return handle;
+            }
+
+            continue;
+        }
+
+        handle = (connect_t*)malloc(sizeof(connect_t));
+
+        if(handle == NULL)
+        {
+            return NULL;
+        }
+
+        handle->scoid = con->scoid;
+        handle->handle = i + 1;
+        handle->state = CONNECTION_CLOSE;
+        handle->access = O_RDONLY;
+        handle->flags = 0;
+        handle->seek = 0;
+        handle->handler = NULL;
+        handle->ring = NULL;
+        MutexInit(&handle->lock);
+#ifdef PROC_STATS
+        handle->ops = 0;
+        handle->bytes = 0;
+#endif
+        memset(handle->handles, 0, sizeof(handle->handles));
+
+        con->handles[i] = handle;
+
+        return handle;
+    }
+
+    return NULL;
 }
 
 void ConnectionSetHandler(connect_t* con, void* handler)
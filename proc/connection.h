@@ -13,17 +13,33 @@
 #include <types.h>
 #include <io_types.h>
 #include <fcntl.h>
+#include <mutex.h>
 
 
 /* Exported types ----------------------------------------- */
-typedef struct
+#define CONNECTION_HANDLES  8
+
+typedef struct Connect connect_t;
+
+// Every open file of a connection has its own handle, handle 0 is the connection itself
+struct Connect
 {
     int32_t  scoid;
+    uint16_t handle;
     uint16_t state;
     uint16_t access;
+    uint16_t flags;
     off_t    seek;
     void*    handler;
-}connect_t;
+    void*    ring;
+    mutex_t  lock;
+    uint32_t refs;      // Registry and requests using the connection, only counted on handle 0
+#ifdef PROC_STATS
+    uint32_t ops;
+    uint32_t bytes;
+#endif
+    connect_t* handles[CONNECTION_HANDLES - 1];
+};
 
 
 /* Exported constants ------------------------------------- */
@@ -31,6 +47,9 @@ typedef struct
 #define CONNECTION_OPEN     1
 #define CONNECTION_MAP      2
 
+// Connection flags
+#define CONNECTION_APPEND   0x1
+
 
 /* Exported macros ---------------------------------------- */
 
@@ -49,8 +68,17 @@ int32_t ConnectionAttach(notify_t* info);
 
 int32_t ConnectionDetach(notify_t* info);
 
+void ConnectionForEach(void (*callBack)(connect_t*, void*), void* arg);
+
+// Every connection returned by ConnectionGet has to be given back with ConnectionPut
 connect_t* ConnectionGet(int32_t scoid);
 
+void ConnectionPut(connect_t* con);
+
+connect_t* ConnectionHandle(connect_t* con, uint32_t handle);
+
+connect_t* ConnectionHandleAlloc(connect_t* con);
+
 void ConnectionSetHandler(connect_t* con, void* handler);
 
 int32_t ConnectionSetState(connect_t* con, uint16_t state);
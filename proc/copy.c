@@ -0,0 +1,145 @@
+/**
+ * @file        copy.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Bulk Copy, Zero Fill and Compare Kernels implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <copy.h>
+#include <string.h>
+
+#if defined(PROC_NEON) && defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define COPY_NEON
+#elif defined(PROC_NEON)
+#warning "PROC_NEON needs -mfpu=neon and a hard or softfp float ABI, the generic kernels are built"
+#endif
+
+
+/* Private types ------------------------------------------ */
+
+// Word loaded from any address, names are not aligned
+typedef struct
+{
+    uint32_t value;
+}__attribute__((packed)) word_t;
+
+
+/* Private constants -------------------------------------- */
+
+// Bytes moved per loop iteration, smaller requests go to the library routines
+#define COPY_BLOCK          64
+#define COPY_PREFETCH       256
+
+
+/* Private macros ----------------------------------------- */
+#define ALIGN_UP(m,a)	(((m) + (a - 1)) & (~(a - 1)))
+
+
+/* Private variables -------------------------------------- */
+
+
+/* Private function prototypes ---------------------------- */
+
+
+/* Private functions -------------------------------------- */
+
+void CopyBulk(void* dst, const void* src, size_t size)
+{
+#ifdef COPY_NEON
+    uint8_t* d = (uint8_t*)dst;
+    const uint8_t* s = (const uint8_t*)src;
+
+    // Extents are page aligned so the loads and stores mostly run on whole cache lines
+    for( ; size >= COPY_BLOCK; size -= COPY_BLOCK, d += COPY_BLOCK, s += COPY_BLOCK)
+    {
+        __builtin_prefetch(s + COPY_PREFETCH);
+
+        uint8x16_t q0 = vld1q_u8(s);
+        uint8x16_t q1 = vld1q_u8(s + 16);
+        uint8x16_t q2 = vld1q_u8(s + 32);
+        uint8x16_t q3 = vld1q_u8(s + 48);
+
+        vst1q_u8(d, q0);
+        vst1q_u8(d + 16, q1);
+        vst1q_u8(d + 32, q2);
+        vst1q_u8(d + 48, q3);
+    }
+
+    memcpy(d, s, size);
+#else
+    memcpy(dst, src, size);
+#endif
+}
+
+void CopyZero(void* dst, size_t size)
+{
+#ifdef COPY_NEON
+    uint8_t* d = (uint8_t*)dst;
+
+    if(size >= COPY_BLOCK)
+    {
+        // Align the stores, the head is cleared by the library
+        size_t head = ALIGN_UP((uint32_t)d, 16) - (uint32_t)d;
+        memset(d, 0x0, head);
+        d += head;
+        size -= head;
+
+        uint8x16_t zero = vdupq_n_u8(0);
+
+        for( ; size >= COPY_BLOCK; size -= COPY_BLOCK, d += COPY_BLOCK)
+        {
+            vst1q_u8(d, zero);
+            vst1q_u8(d + 16, zero);
+            vst1q_u8(d + 32, zero);
+            vst1q_u8(d + 48, zero);
+        }
+    }
+
+    memset(d, 0x0, size);
+#else
+    memset(dst, 0x0, size);
+#endif
+}
+
+uint32_t CopyEqual(const void* a, const void* b, size_t size)
+{
+    const uint8_t* x = (const uint8_t*)a;
+    const uint8_t* y = (const uint8_t*)b;
+
+#ifdef COPY_NEON
+    for( ; size >= 16; size -= 16, x += 16, y += 16)
+    {
+        // Any differing byte leaves a non zero lane
+        uint8x16_t diff = veorq_u8(vld1q_u8(x), vld1q_u8(y));
+        uint32x4_t lanes = vreinterpretq_u32_u8(diff);
+        uint32x2_t fold = vorr_u32(vget_low_u32(lanes), vget_high_u32(lanes));
+
+        if((vget_lane_u32(fold, 0) | vget_lane_u32(fold, 1)) != 0)
+        {
+            return FALSE;
+        }
+    }
+#else
+    // Names are short, words are compared without calling the library
+    for( ; size >= sizeof(word_t); size -= sizeof(word_t), x += sizeof(word_t), y += sizeof(word_t))
+    {
+        if(((const word_t*)x)->value != ((const word_t*)y)->value)
+        {
+            return FALSE;
+        }
+    }
+#endif
+
+    for( ; size > 0; size--, x++, y++)
+    {
+        if(*x != *y)
+        {
+            return FALSE;
+        }
+    }
+
+    return TRUE;
+}
@@ -0,0 +1,34 @@
+/**
+ * @file        copy.h
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Bulk Copy, Zero Fill and Compare Kernels Definition Header File
+*/
+
+#ifndef _COPY_H_
+#define _COPY_H_
+
+/* Includes ----------------------------------------------- */
+#include <types.h>
+
+
+/* Exported types ----------------------------------------- */
+
+
+/* Exported constants ------------------------------------- */
+
+
+/* Exported macros ---------------------------------------- */
+
+
+/* Exported functions ------------------------------------- */
+
+void CopyBulk(void* dst, const void* src, size_t size);
+
+void CopyZero(void* dst, size_t size);
+
+// Returns TRUE if both buffers hold the same bytes
+uint32_t CopyEqual(const void* a, const void* b, size_t size);
+
+#endif
@@ -0,0 +1,277 @@
+/**
+ * @file        dcache.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Proc Path Lookup Cache implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <dcache.h>
+#include <hindex.h>
+#include <string.h>
+#include <mutex.h>
+#include <copy.h>
+
+
+/* Private types ------------------------------------------ */
+typedef struct
+{
+    int16_t  next;      // Hash chain
+    int16_t  older;     // LRU list
+    int16_t  newer;
+    uint16_t type;
+    uint32_t hash;
+    void*    object;
+    uint16_t len;
+    char     path[62];
+}dentry_cache_t;
+
+
+/* Private constants -------------------------------------- */
+#define DCACHE_ENTRIES      64
+#define DCACHE_BUCKETS      64
+#define DCACHE_NONE         (-1)
+#define DCACHE_TYPE_NONE    0xFFFF
+
+
+/* Private macros ----------------------------------------- */
+
+
+/* Private variables -------------------------------------- */
+
+static struct
+{
+    dentry_cache_t entries[DCACHE_ENTRIES];
+    int16_t        buckets[DCACHE_BUCKETS];
+    int16_t        newest;
+    int16_t        oldest;
+    int16_t        used;
+    uint32_t       hits;
+    uint32_t       misses;
+}Dcache = { .newest = DCACHE_NONE, .oldest = DCACHE_NONE };
+
+// Lookups update the LRU order so they are serialized even under the tree read lock
+static mutex_t dcacheLock = MUTEX_INITIALIZER;
+
+
+/* Private function prototypes ---------------------------- */
+
+void DcacheBucketsInit()
+{
+    uint32_t i;
+    for(i = 0; i < DCACHE_BUCKETS; i++)
+    {
+        Dcache.buckets[i] = DCACHE_NONE;
+    }
+}
+
+void DcacheUnlink(int16_t index)
+{
+    dentry_cache_t* entry = &Dcache.entries[index];
+
+    if(entry->older != DCACHE_NONE) Dcache.entries[entry->older].newer = entry->newer;
+    else Dcache.oldest = entry->newer;
+
+    if(entry->newer != DCACHE_NONE) Dcache.entries[entry->newer].older = entry->older;
+    else Dcache.newest = entry->older;
+}
+
+void DcachePushNewest(int16_t index)
+{
+    dentry_cache_t* entry = &Dcache.entries[index];
+
+    entry->newer = DCACHE_NONE;
+    entry->older = Dcache.newest;
+
+    if(Dcache.newest != DCACHE_NONE) Dcache.entries[Dcache.newest].newer = index;
+    else Dcache.oldest = index;
+
+    Dcache.newest = index;
+}
+
+void DcacheUnhash(int16_t index)
+{
+    int16_t* it = &Dcache.buckets[Dcache.entries[index].hash & (DCACHE_BUCKETS - 1)];
+    for( ; *it != DCACHE_NONE; it = &Dcache.entries[*it].next)
+    {
+        if(*it == index)
+        {
+            *it = Dcache.entries[index].next;
+            break;
+        }
+    }
+}
+
+void DcacheEvict(int16_t index)
+{
+    DcacheUnhash(index);
+    DcacheUnlink(index);
+    Dcache.entries[index].type = DCACHE_TYPE_NONE;
+}
+
+int16_t DcacheFind(const char* path, uint32_t len, uint32_t hash)
+{
+    int16_t index = Dcache.buckets[hash & (DCACHE_BUCKETS - 1)];
+    for( ; index != DCACHE_NONE; index = Dcache.entries[index].next)
+    {
+        dentry_cache_t* entry = &Dcache.entries[index];
+
+        if(entry->hash == hash && entry->len == len && CopyEqual(entry->path, path, len))
+        {
+            return index;
+        }
+    }
+
+    return DCACHE_NONE;
+}
+
+
+/* Private functions -------------------------------------- */
+
+int32_t DcacheLookup(const char* path, uint16_t type, void** object)
+{
+    uint32_t len = strlen(path);
+
+    MutexLock(&dcacheLock);
+
+    if(Dcache.used == 0 || len > sizeof(Dcache.entries[0].path))
+    {
+        Dcache.misses++;
+        MutexUnlock(&dcacheLock);
+        return E_NO_RES;
+    }
+
+    int16_t index = DcacheFind(path, len, HashIndexHash(path, len));
+
+    // Negative entries are only recorded for file lookups
+    if(index == DCACHE_NONE || (Dcache.entries[index].type != type &&
+      !(type == DCACHE_FILE && Dcache.entries[index].type == DCACHE_NEGATIVE)))
+    {
+        Dcache.misses++;
+        MutexUnlock(&dcacheLock);
+        return E_NO_RES;
+    }
+
+    // Move entry to the head of the LRU list
+    DcacheUnlink(index);
+    DcachePushNewest(index);
+
+    Dcache.hits++;
+
+    *object = Dcache.entries[index].object;
+
+    MutexUnlock(&dcacheLock);
+
+    return E_OK;
+}
+
+void DcacheInsert(const char* path, uint16_t type, void* object)
+{
+    uint32_t len = strlen(path);
+
+    // Long paths are not cached
+    if(len > sizeof(Dcache.entries[0].path))
+    {
+        return;
+    }
+
+    MutexLock(&dcacheLock);
+
+    if(Dcache.used == 0 && Dcache.newest == DCACHE_NONE)
+    {
+        DcacheBucketsInit();
+    }
+
+    uint32_t hash = HashIndexHash(path, len);
+    int16_t index = DcacheFind(path, len, hash);
+
+    if(index != DCACHE_NONE)
+    {
+        DcacheEvict(index);
+    }
+    else if(Dcache.used < DCACHE_ENTRIES)
+    {
+        index = Dcache.used++;
+    }
+    else
+    {
+        // Search for a free slot before recycling the least recently used one
+        for(index = 0; index < DCACHE_ENTRIES; index++)
+        {
+            if(Dcache.entries[index].type == DCACHE_TYPE_NONE)
+            {
+                break;
+            }
+        }
+
+        if(index == DCACHE_ENTRIES)
+        {
+            index = Dcache.oldest;
+            DcacheEvict(index);
+        }
+    }
+
+    dentry_cache_t* entry = &Dcache.entries[index];
+    entry->type = type;
+    entry->hash = hash;
+    entry->object = object;
+    entry->len = (uint16_t)len;
+    memcpy(entry->path, path, len);
+
+    entry->next = Dcache.buckets[hash & (DCACHE_BUCKETS - 1)];
+    Dcache.buckets[hash & (DCACHE_BUCKETS - 1)] = index;
+    DcachePushNewest(index);
+
+    MutexUnlock(&dcacheLock);
+}
+
+void DcacheInvalidateNegative()
+{
+    MutexLock(&dcacheLock);
+
+    int16_t index;
+    for(index = 0; index < Dcache.used; index++)
+    {
+        if(Dcache.entries[index].type == DCACHE_NEGATIVE)
+        {
+            DcacheEvict(index);
+        }
+    }
+
+    MutexUnlock(&dcacheLock);
+}
+
+void DcacheInvalidateObject(void* object)
+{
+    MutexLock(&dcacheLock);
+
+    int16_t index;
+    for(index = 0; index < Dcache.used; index++)
+    {
+        if(Dcache.entries[index].type != DCACHE_TYPE_NONE && Dcache.entries[index].object == object)
+        {
+            DcacheEvict(index);
+        }
+    }
+
+    MutexUnlock(&dcacheLock);
+}
+
+void DcacheStats(dcache_stats_t* stats)
+{
+    MutexLock(&dcacheLock);
+
+    stats->hits = Dcache.hits;
+    stats->misses = Dcache.misses;
+    stats->capacity = DCACHE_ENTRIES;
+    stats->entries = 0;
+
+    int16_t index;
+    for(index = Dcache.newest; index != DCACHE_NONE; index = Dcache.entries[index].older)
+    {
+        stats->entries++;
+    }
+
+    MutexUnlock(&dcacheLock);
+}
@@ -0,0 +1,47 @@
+/**
+ * @file        dcache.h
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Proc Path Lookup Cache Definition Header File
+*/
+
+#ifndef _DCACHE_H_
+#define _DCACHE_H_
+
+/* Includes ----------------------------------------------- */
+#include <types.h>
+
+
+/* Exported types ----------------------------------------- */
+typedef struct
+{
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t entries;
+    uint32_t capacity;
+}dcache_stats_t;
+
+
+/* Exported constants ------------------------------------- */
+#define DCACHE_NEGATIVE     0
+#define DCACHE_FILE         1
+#define DCACHE_DIR          2
+
+
+/* Exported macros ---------------------------------------- */
+
+
+/* Exported functions ------------------------------------- */
+
+int32_t DcacheLookup(const char* path, uint16_t type, void** object);
+
+void DcacheInsert(const char* path, uint16_t type, void* object);
+
+void DcacheInvalidateNegative();
+
+void DcacheInvalidateObject(void* object);
+
+void DcacheStats(dcache_stats_t* stats);
+
+#endif
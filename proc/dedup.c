@@ -0,0 +1,193 @@
+/**
+ * @file        dedup.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Shared File Data and Content Index implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <dedup.h>
+#include <mutex.h>
+#include <copy.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Private types ------------------------------------------ */
+
+
+/* Private constants -------------------------------------- */
+
+
+/* Private macros ----------------------------------------- */
+
+
+/* Private variables -------------------------------------- */
+
+// Content index of shared data, keyed by a hash of the content
+static hindex_t contents = {NULL, 0, 0};
+
+// Protects the index and the last reference of every share
+static mutex_t dedupLock = MUTEX_INITIALIZER;
+
+// Bytes not allocated thanks to sharing indexed content
+static size_t saved = 0;
+
+
+/* Private function prototypes ---------------------------- */
+
+share_t* DedupLookup(uint32_t hash, const void* data, size_t size)
+{
+    hnode_t* node = HashIndexBucket(&contents, hash);
+    for( ; node != NULL; node = node->next)
+    {
+        share_t* share = HINDEX_ENTRY(node, share_t, node);
+
+        if((node->hash == hash) && (share->size == size) && CopyEqual(share->data, data, size))
+        {
+            return share;
+        }
+    }
+
+    return NULL;
+}
+
+
+/* Private functions -------------------------------------- */
+
+uint32_t* DedupShareAlloc()
+{
+    share_t* share = (share_t*)malloc(sizeof(share_t));
+
+    if(share == NULL)
+    {
+        return NULL;
+    }
+
+    share->refs = 1;
+    share->indexed = 0;
+
+    return &share->refs;
+}
+
+uint32_t DedupShareRelease(uint32_t* refs)
+{
+    share_t* share = (share_t*)refs;
+
+    MutexLock(&dedupLock);
+
+    uint32_t count = __sync_sub_and_fetch(&share->refs, 1);
+
+    if(share->indexed)
+    {
+        if(count == 0)
+        {
+            HashIndexRemove(&contents, &share->node);
+        }
+        else
+        {
+            saved -= share->extent;
+        }
+    }
+
+    MutexUnlock(&dedupLock);
+
+    if(count == 0)
+    {
+        free(share);
+    }
+
+    return count;
+}
+
+void DedupShareAdd(uint32_t* refs)
+{
+    share_t* share = (share_t*)refs;
+
+    MutexLock(&dedupLock);
+
+    __sync_add_and_fetch(&share->refs, 1);
+
+    // Every further reference of indexed content is one copy not allocated, released ones are taken off again
+    if(share->indexed)
+    {
+        saved += share->extent;
+    }
+
+    MutexUnlock(&dedupLock);
+}
+
+int32_t DedupShareTake(uint32_t* refs)
+{
+    share_t* share = (share_t*)refs;
+
+    MutexLock(&dedupLock);
+
+    // Only the last sharer may take the data back, its content is about to change
+    if(share->refs != 1)
+    {
+        MutexUnlock(&dedupLock);
+        return E_BUSY;
+    }
+
+    if(share->indexed)
+    {
+        HashIndexRemove(&contents, &share->node);
+    }
+
+    MutexUnlock(&dedupLock);
+
+    free(share);
+
+    return E_OK;
+}
+
+share_t* DedupIndex(uint32_t* refs, void* data, size_t size, size_t extent, uint32_t flags)
+{
+    share_t* share = (share_t*)refs;
+
+    // Hashing runs outside the lock, the caller holds the data stable
+    uint32_t hash = HashIndexHash((const char*)data, size);
+
+    MutexLock(&dedupLock);
+
+    if(share->indexed)
+    {
+        MutexUnlock(&dedupLock);
+        return share;
+    }
+
+    share_t* match = DedupLookup(hash, data, size);
+
+    // Same content is already stored, the caller drops its own copy
+    if(match != NULL)
+    {
+        __sync_add_and_fetch(&match->refs, 1);
+        saved += match->extent;
+        MutexUnlock(&dedupLock);
+        return match;
+    }
+
+    share->data = data;
+    share->size = size;
+    share->extent = extent;
+    share->flags = flags;
+    share->node.hash = hash;
+
+    if(HashIndexInsert(&contents, &share->node) == E_OK)
+    {
+        share->indexed = 1;
+        // Clones sharing the data before it was indexed count as saved too
+        saved += (share->refs - 1) * extent;
+    }
+
+    MutexUnlock(&dedupLock);
+
+    return share;
+}
+
+size_t DedupSaved()
+{
+    return saved;
+}
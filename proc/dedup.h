@@ -0,0 +1,52 @@
+/**
+ * @file        dedup.h
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Shared File Data and Content Index Definition Header File
+*/
+
+#ifndef _DEDUP_H_
+#define _DEDUP_H_
+
+/* Includes ----------------------------------------------- */
+#include <types.h>
+#include <hindex.h>
+
+
+/* Exported types ----------------------------------------- */
+
+// Data shared by several extents, extents point at refs
+typedef struct
+{
+    uint32_t refs;
+    uint32_t indexed;
+    hnode_t  node;
+    void*    data;
+    size_t   size;      // Bytes of content compared
+    size_t   extent;    // Size of the shared extent
+    uint32_t flags;     // Data origin
+}share_t;
+
+
+/* Exported constants ------------------------------------- */
+
+
+/* Exported macros ---------------------------------------- */
+
+
+/* Exported functions ------------------------------------- */
+
+uint32_t* DedupShareAlloc();
+
+uint32_t DedupShareRelease(uint32_t* refs);
+
+void DedupShareAdd(uint32_t* refs);
+
+int32_t DedupShareTake(uint32_t* refs);
+
+share_t* DedupIndex(uint32_t* refs, void* data, size_t size, size_t extent, uint32_t flags);
+
+size_t DedupSaved();
+
+#endif
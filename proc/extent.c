@@ -0,0 +1,593 @@
+/**
+ * @file        extent.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       File Data Extents implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <extent.h>
+#include <rfs.h>
+#include <dedup.h>
+#include <checkpoint.h>
+#include <copy.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mman.h>
+
+
+/* Private types ------------------------------------------ */
+
+
+/* Private constants -------------------------------------- */
+
+// Only files up to this many pages are deduplicated
+#define EXTENT_DEDUP_PAGES  16
+
+
+/* Private macros ----------------------------------------- */
+#define ALIGN_UP(m,a)	(((m) + (a - 1)) & (~(a - 1)))
+
+
+/* Private variables -------------------------------------- */
+
+
+/* Private function prototypes ---------------------------- */
+
+extent_t* ExtentAlloc(size_t size)
+{
+    extent_t* extent = (extent_t*)malloc(sizeof(extent_t));
+
+    if(extent == NULL)
+    {
+        return NULL;
+    }
+
+    extent->data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANON, NOFD, 0x0);
+
+    if(extent->data == NULL)
+    {
+        free(extent);
+        return NULL;
+    }
+
+    extent->next = NULL;
+    extent->size = size;
+    extent->flags = EXTENT_ANON;
+    extent->refs = NULL;
+
+    return extent;
+}
+
+// Returns the bytes given back, data still shared with other extents is kept
+size_t ExtentDataRelease(extent_t* extent)
+{
+    // Shared data goes with the last extent referencing it
+    if((extent->refs != NULL) && (DedupShareRelease(extent->refs) > 0))
+    {
+        return 0;
+    }
+
+    if(extent->flags & EXTENT_RFS)
+    {
+        RfsRelease(extent->data, extent->size);
+    }
+    else if(extent->flags & EXTENT_CKPT)
+    {
+        CheckpointRelease(extent->data, extent->size);
+    }
+    else if(extent->flags & EXTENT_HEAP)
+    {
+        free(extent->data);
+    }
+    else
+    {
+        munmap(extent->data, extent->size);
+    }
+
+    return extent->size;
+}
+
+size_t ExtentRelease(extent_t* extent)
+{
+    size_t freed = ExtentDataRelease(extent);
+
+    free(extent);
+
+    return freed;
+}
+
+void ExtentsAppend(extents_t* extents, extent_t* extent)
+{
+    if(extents->last != NULL) extents->last->next = extent;
+    else extents->first = extent;
+
+    extents->last = extent;
+    extents->capacity += extent->size;
+    extents->count++;
+}
+
+extent_t* ExtentsFind(extents_t* extents, size_t offset, size_t* start)
+{
+    size_t base = 0;
+    extent_t* extent = extents->first;
+    for( ; extent != NULL; extent = extent->next)
+    {
+        if(offset < base + extent->size)
+        {
+            *start = base;
+            return extent;
+        }
+
+        base += extent->size;
+    }
+
+    return NULL;
+}
+
+// Content before size is held in whole pages, only the last one may be shorter
+uint32_t ExtentsPaged(extents_t* extents, size_t size)
+{
+    size_t base = 0;
+
+    extent_t* extent = extents->first;
+    for( ; (extent != NULL) && (base < size); extent = extent->next)
+    {
+        if((extent->size > EXTENT_PAGE_SIZE) || ((extent->size < EXTENT_PAGE_SIZE) && ((base + extent->size) < size)))
+        {
+            return 0;
+        }
+
+        base += extent->size;
+    }
+
+    return (base >= size);
+}
+
+// Copies the content into page sized extents, image and checkpoint pages are never copied for it
+int32_t ExtentsSplit(extents_t* extents, size_t size)
+{
+    if(ExtentsPaged(extents, size))
+    {
+        return E_OK;
+    }
+
+    extent_t* extent = extents->first;
+    for( ; extent != NULL; extent = extent->next)
+    {
+        if(extent->flags & (EXTENT_RFS | EXTENT_CKPT))
+        {
+            return E_BUSY;
+        }
+    }
+
+    extents_t pages = {NULL, NULL, 0, 0};
+    size_t base;
+
+    for(base = 0; base < size; base += EXTENT_PAGE_SIZE)
+    {
+        extent_t* page = ExtentAlloc(EXTENT_PAGE_SIZE);
+
+        if(page == NULL)
+        {
+            ExtentsFree(&pages);
+            return E_ERROR;
+        }
+
+        ExtentsRead(extents, base, page->data, (((size - base) < EXTENT_PAGE_SIZE) ? (size - base) : (EXTENT_PAGE_SIZE)));
+        ExtentsAppend(&pages, page);
+    }
+
+    ExtentsFree(extents);
+    *extents = pages;
+
+    return E_OK;
+}
+
+// Shares the extent data with an indexed page holding the same content, returns the bytes deduplicated
+size_t ExtentDedup(extent_t* extent, size_t size)
+{
+    if(extent->refs == NULL)
+    {
+        extent->refs = DedupShareAlloc();
+
+        if(extent->refs == NULL)
+        {
+            return 0;
+        }
+    }
+
+    share_t* match = DedupIndex(extent->refs, extent->data, size, extent->size, extent->flags & ~EXTENT_COW);
+
+    // Indexed data is copied before it is written, or taken back if nobody shares it
+    extent->flags |= EXTENT_COW;
+
+    if(&match->refs == extent->refs)
+    {
+        return 0;
+    }
+
+    // Same content is stored elsewhere, this copy is dropped
+    ExtentDataRelease(extent);
+
+    extent->data = match->data;
+    extent->size = match->extent;
+    extent->flags = match->flags | EXTENT_COW;
+    extent->refs = &match->refs;
+
+    return size;
+}
+
+
+/* Private functions -------------------------------------- */
+
+int32_t ExtentsInit(extents_t* extents, void* data, size_t size, uint32_t flags)
+{
+    extents->first = NULL;
+    extents->last = NULL;
+    extents->capacity = 0;
+    extents->count = 0;
+
+    if(data == NULL || size == 0)
+    {
+        return E_OK;
+    }
+
+    extent_t* extent = (extent_t*)malloc(sizeof(extent_t));
+
+    if(extent == NULL)
+    {
+        return E_ERROR;
+    }
+
+    extent->next = NULL;
+    extent->data = data;
+    extent->size = size;
+    extent->flags = flags;
+    extent->refs = NULL;
+
+    ExtentsAppend(extents, extent);
+
+    return E_OK;
+}
+
+int32_t ExtentsGrow(extents_t* extents, size_t capacity)
+{
+    if(capacity <= extents->capacity)
+    {
+        return E_OK;
+    }
+
+    // Grow geometrically so a file grown page by page only allocates log(n) extents
+    size_t size = capacity - extents->capacity;
+
+    if(size < extents->capacity)
+    {
+        size = extents->capacity;
+    }
+
+    extent_t* extent = ExtentAlloc(ALIGN_UP(size, EXTENT_PAGE_SIZE));
+
+    // Retry with the exact size if memory is short
+    if(extent == NULL)
+    {
+        extent = ExtentAlloc(ALIGN_UP(capacity - extents->capacity, EXTENT_PAGE_SIZE));
+    }
+
+    if(extent == NULL)
+    {
+        return E_ERROR;
+    }
+
+    ExtentsAppend(extents, extent);
+
+    return E_OK;
+}
+
+int32_t ExtentsShrink(extents_t* extents, size_t capacity)
+{
+    // The first extent is always kept, it may be mapped by clients
+    if(extents->first == NULL)
+    {
+        return E_OK;
+    }
+
+    size_t base = extents->first->size;
+    extent_t* keep = extents->first;
+
+    // Find the last extent holding data bellow the new capacity
+    while(keep->next != NULL && base < capacity)
+    {
+        base += keep->next->size;
+        keep = keep->next;
+    }
+
+    extent_t* extent = keep->next;
+    keep->next = NULL;
+    extents->last = keep;
+    extents->capacity = base;
+
+    // Release the tail extents
+    while(extent != NULL)
+    {
+        extent_t* next = extent->next;
+        ExtentRelease(extent);
+        extents->count--;
+        extent = next;
+    }
+
+    return E_OK;
+}
+
+void* ExtentsMap(extents_t* extents, size_t offset, size_t* size)
+{
+    size_t start;
+    extent_t* extent = ExtentsFind(extents, offset, &start);
+
+    if(extent == NULL)
+    {
+        *size = 0;
+        return NULL;
+    }
+
+    // Contiguous bytes available from offset
+    *size = extent->size - (offset - start);
+
+    return (char*)extent->data + (offset - start);
+}
+
+size_t ExtentsRead(extents_t* extents, size_t offset, void* dst, size_t size)
+{
+    size_t done = 0;
+
+    while(done < size)
+    {
+        size_t avail;
+        const char* src = (const char*)ExtentsMap(extents, offset + done, &avail);
+
+        if(src == NULL)
+        {
+            break;
+        }
+
+        size_t chunk = ((size - done) < avail) ? (size - done) : (avail);
+        CopyBulk((char*)dst + done, src, chunk);
+        done += chunk;
+    }
+
+    return done;
+}
+
+size_t ExtentsWrite(extents_t* extents, size_t offset, const void* src, size_t size)
+{
+    size_t done = 0;
+
+    while(done < size)
+    {
+        size_t avail;
+        char* dst = (char*)ExtentsMap(extents, offset + done, &avail);
+
+        if(dst == NULL)
+        {
+            break;
+        }
+
+        size_t chunk = ((size - done) < avail) ? (size - done) : (avail);
+        CopyBulk(dst, (const char*)src + done, chunk);
+        done += chunk;
+    }
+
+    return done;
+}
+
+size_t ExtentsZero(extents_t* extents, size_t offset, size_t size)
+{
+    size_t done = 0;
+
+    while(done < size)
+    {
+        size_t avail;
+        char* dst = (char*)ExtentsMap(extents, offset + done, &avail);
+
+        if(dst == NULL)
+        {
+            break;
+        }
+
+        size_t chunk = ((size - done) < avail) ? (size - done) : (avail);
+        CopyZero(dst, chunk);
+        done += chunk;
+    }
+
+    return done;
+}
+
+int32_t ExtentsCoalesce(extents_t* extents)
+{
+    if(extents->count <= 1)
+    {
+        return E_OK;
+    }
+
+    extent_t* extent = ExtentAlloc(extents->capacity);
+
+    if(extent == NULL)
+    {
+        return E_ERROR;
+    }
+
+    // Move all data into a single extent
+    char* dst = (char*)extent->data;
+    extent_t* it = extents->first;
+    while(it != NULL)
+    {
+        extent_t* next = it->next;
+        CopyBulk(dst, it->data, it->size);
+        dst += it->size;
+        ExtentRelease(it);
+        it = next;
+    }
+
+    extents->first = NULL;
+    extents->last = NULL;
+    extents->capacity = 0;
+    extents->count = 0;
+
+    ExtentsAppend(extents, extent);
+
+    return E_OK;
+}
+
+int32_t ExtentsDetach(extents_t* extents, uint32_t origin)
+{
+    extent_t* extent = extents->first;
+    for( ; extent != NULL; extent = extent->next)
+    {
+        if(!(extent->flags & origin))
+        {
+            continue;
+        }
+
+        // Last sharer owns the data again
+        if((extent->refs != NULL) && (DedupShareTake(extent->refs) == E_OK))
+        {
+            extent->refs = NULL;
+            extent->flags &= ~EXTENT_COW;
+        }
+
+        if(!(extent->flags & (EXTENT_RFS | EXTENT_CKPT | EXTENT_COW)))
+        {
+            continue;
+        }
+
+        void* data = mmap(NULL, extent->size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANON, NOFD, 0x0);
+
+        if(data == NULL)
+        {
+            return E_ERROR;
+        }
+
+        CopyBulk(data, extent->data, extent->size);
+
+        // Shared data stays with the other sharers, image pages are no longer referenced by this extent
+        ExtentDataRelease(extent);
+
+        extent->data = data;
+        extent->flags = EXTENT_ANON;
+        extent->refs = NULL;
+    }
+
+    return E_OK;
+}
+
+int32_t ExtentsPrivate(extents_t* extents)
+{
+    return ExtentsDetach(extents, EXTENT_RFS | EXTENT_CKPT | EXTENT_COW);
+}
+
+uint32_t ExtentsBorrowed(extents_t* extents)
+{
+    extent_t* extent = extents->first;
+    for( ; extent != NULL; extent = extent->next)
+    {
+        if(extent->flags & (EXTENT_RFS | EXTENT_CKPT | EXTENT_COW))
+        {
+            return TRUE;
+        }
+    }
+
+    return FALSE;
+}
+
+int32_t ExtentsClone(extents_t* dst, extents_t* src)
+{
+    extent_t* extent = src->first;
+    for( ; extent != NULL; extent = extent->next)
+    {
+        extent_t* clone = (extent_t*)malloc(sizeof(extent_t));
+
+        if(clone == NULL)
+        {
+            return E_ERROR;
+        }
+
+        if(extent->refs == NULL)
+        {
+            extent->refs = DedupShareAlloc();
+
+            if(extent->refs == NULL)
+            {
+                free(clone);
+                return E_ERROR;
+            }
+        }
+
+        // Both sides copy the data before writing it
+        extent->flags |= EXTENT_COW;
+        DedupShareAdd(extent->refs);
+
+        clone->next = NULL;
+        clone->data = extent->data;
+        clone->size = extent->size;
+        clone->flags = extent->flags;
+        clone->refs = extent->refs;
+
+        ExtentsAppend(dst, clone);
+    }
+
+    return E_OK;
+}
+
+size_t ExtentsDedup(extents_t* extents, size_t size)
+{
+    // Larger files would cost a long page list and hashing all of their data on every close
+    if((size == 0) || (size > (EXTENT_DEDUP_PAGES * EXTENT_PAGE_SIZE)))
+    {
+        return 0;
+    }
+
+    // Content is compared page by page so files sharing only some of their pages still share them
+    if(ExtentsSplit(extents, size) != E_OK)
+    {
+        return 0;
+    }
+
+    size_t deduped = 0;
+    size_t base = 0;
+
+    extent_t* extent = extents->first;
+    for( ; (extent != NULL) && (base < size); extent = extent->next)
+    {
+        size_t length = (((size - base) < extent->size) ? (size - base) : (extent->size));
+        size_t before = extent->size;
+
+        deduped += ExtentDedup(extent, length);
+
+        extents->capacity += extent->size;
+        extents->capacity -= before;
+        base += before;
+    }
+
+    return deduped;
+}
+
+size_t ExtentsFree(extents_t* extents)
+{
+    size_t freed = 0;
+
+    extent_t* extent = extents->first;
+    while(extent != NULL)
+    {
+        extent_t* next = extent->next;
+        freed += ExtentRelease(extent);
+        extent = next;
+    }
+
+    extents->first = NULL;
+    extents->last = NULL;
+    extents->capacity = 0;
+    extents->count = 0;
+
+    return freed;
+}
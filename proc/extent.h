@@ -0,0 +1,84 @@
+/**
+ * @file        extent.h
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       File Data Extents Definition Header File
+*/
+
+#ifndef _EXTENT_H_
+#define _EXTENT_H_
+
+/* Includes ----------------------------------------------- */
+#include <types.h>
+
+
+/* Exported types ----------------------------------------- */
+typedef struct Extent extent_t;
+
+struct Extent
+{
+    extent_t* next;
+    void*     data;
+    size_t    size;
+    uint32_t  flags;
+    uint32_t* refs;     // Extents sharing the data, NULL while not shared
+};
+
+typedef struct
+{
+    extent_t* first;
+    extent_t* last;
+    size_t    capacity;
+    uint32_t  count;
+}extents_t;
+
+
+/* Exported constants ------------------------------------- */
+#define EXTENT_PAGE_SIZE    4096
+
+// Extent data origin
+#define EXTENT_ANON         0x0     // Anonymous mapping owned by the extent
+#define EXTENT_RFS          0x1     // Read only raw file system image pages
+#define EXTENT_HEAP         0x2     // Heap buffer
+#define EXTENT_COW          0x4     // Data shared with clones, copied on the first write
+#define EXTENT_CKPT         0x8     // Pages of the checkpoint image, copied on the first write
+
+
+/* Exported macros ---------------------------------------- */
+
+
+/* Exported functions ------------------------------------- */
+
+int32_t ExtentsInit(extents_t* extents, void* data, size_t size, uint32_t flags);
+
+int32_t ExtentsGrow(extents_t* extents, size_t capacity);
+
+int32_t ExtentsShrink(extents_t* extents, size_t capacity);
+
+void* ExtentsMap(extents_t* extents, size_t offset, size_t* size);
+
+size_t ExtentsRead(extents_t* extents, size_t offset, void* dst, size_t size);
+
+size_t ExtentsWrite(extents_t* extents, size_t offset, const void* src, size_t size);
+
+size_t ExtentsZero(extents_t* extents, size_t offset, size_t size);
+
+int32_t ExtentsCoalesce(extents_t* extents);
+
+// Copies the extents of the given origins, ExtentsPrivate copies every extent not owned by the file
+int32_t ExtentsDetach(extents_t* extents, uint32_t origin);
+
+int32_t ExtentsPrivate(extents_t* extents);
+
+// TRUE if ExtentsPrivate would copy anything
+uint32_t ExtentsBorrowed(extents_t* extents);
+
+int32_t ExtentsClone(extents_t* dst, extents_t* src);
+
+size_t ExtentsDedup(extents_t* extents, size_t size);
+
+// Returns the bytes actually given back, data shared with other files stays
+size_t ExtentsFree(extents_t* extents);
+
+#endif
@@ -0,0 +1,368 @@
+/**
+ * @file        fifo.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       FIFO File Data implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <fifo.h>
+#include <ipc.h>
+#include <mman.h>
+#include <mutex.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Private types ------------------------------------------ */
+
+// Request waiting for data or space, its reply is sent once it completes
+typedef struct Waiter waiter_t;
+
+struct Waiter
+{
+    waiter_t* next;
+    int32_t   rcvid;
+    uint32_t  size;
+    uint32_t  done;
+};
+
+// Size and data area are kept here, a mapping reader can rewrite the shared header
+struct Fifo
+{
+    fifo_hdr_t* ring;
+    char*       data;
+    uint32_t    size;
+    uint32_t    head;
+    mutex_t     lock;
+    waiter_t*   readers;
+    waiter_t*   writers;
+};
+
+
+/* Private constants -------------------------------------- */
+#define FIFO_PAGE_SIZE      4096
+
+
+/* Private macros ----------------------------------------- */
+
+
+/* Private variables -------------------------------------- */
+
+
+/* Private function prototypes ---------------------------- */
+
+// Mapping readers move the tail themselves, a bogus one is clamped to the ring size
+static inline uint32_t FifoUsed(fifo_t* fifo)
+{
+    uint32_t used = fifo->head - fifo->ring->tail;
+
+    return ((used > fifo->size) ? (fifo->size) : (used));
+}
+
+void FifoQueue(waiter_t** queue, int32_t rcvid, uint32_t size, uint32_t done)
+{
+    waiter_t* waiter = (waiter_t*)malloc(sizeof(waiter_t));
+
+    if(waiter == NULL)
+    {
+        MsgRespond(rcvid, ((done) ? ((int32_t)done) : (-1)), NULL, 0);
+        return;
+    }
+
+    waiter->next = NULL;
+    waiter->rcvid = rcvid;
+    waiter->size = size;
+    waiter->done = done;
+
+    // Waiters are served in arrival order
+    while(*queue != NULL)
+    {
+        queue = &(*queue)->next;
+    }
+
+    *queue = waiter;
+}
+
+void FifoDequeue(waiter_t** queue)
+{
+    waiter_t* waiter = *queue;
+    *queue = waiter->next;
+    free(waiter);
+}
+
+// Receives writer data into the free space, returns the bytes received or -1 if the writer went away
+int32_t FifoFill(fifo_t* fifo, int32_t rcvid, const char* buffer, uint32_t received, uint32_t msgOffset, uint32_t size)
+{
+    char* data = fifo->data;
+    uint32_t mask = fifo->size - 1;
+    uint32_t space = fifo->size - FifoUsed(fifo);
+    uint32_t done = 0;
+
+    if(size > space)
+    {
+        size = space;
+    }
+
+    // Free space wraps at most once
+    while(done < size)
+    {
+        uint32_t pos = (fifo->head + done) & mask;
+        uint32_t chunk = fifo->size - pos;
+
+        if(chunk > (size - done))
+        {
+            chunk = size - done;
+        }
+
+        // Data still in the dispatcher buffer is copied, the rest is read from the client
+        if((msgOffset + done) < received)
+        {
+            if(chunk > (received - msgOffset - done))
+            {
+                chunk = received - msgOffset - done;
+            }
+
+            memcpy(&data[pos], &buffer[msgOffset + done], chunk);
+        }
+        else
+        {
+            int32_t got = MsgRead(rcvid, &data[pos], chunk, msgOffset + done);
+
+            if(got <= 0)
+            {
+                break;
+            }
+
+            chunk = got;
+        }
+
+        done += chunk;
+    }
+
+    // Data is in place before readers can see it
+    __sync_synchronize();
+    fifo->head += done;
+    fifo->ring->head = fifo->head;
+
+    return (((done == 0) && (size != 0)) ? (-1) : ((int32_t)done));
+}
+
+// Copies data to a reader reply, returns the bytes consumed or -1 if the reader went away
+int32_t FifoDrain(fifo_t* fifo, int32_t rcvid, uint32_t size)
+{
+    char* data = fifo->data;
+    uint32_t mask = fifo->size - 1;
+    uint32_t tail = fifo->head - FifoUsed(fifo);
+    uint32_t used = fifo->head - tail;
+    uint32_t done = 0;
+
+    if(size > used)
+    {
+        size = used;
+    }
+
+    __sync_synchronize();
+
+    while(done < size)
+    {
+        uint32_t pos = (tail + done) & mask;
+        uint32_t chunk = fifo->size - pos;
+
+        if(chunk > (size - done))
+        {
+            chunk = size - done;
+        }
+
+        if(MsgWrite(rcvid, &data[pos], chunk, done) < 0)
+        {
+            return -1;
+        }
+
+        done += chunk;
+    }
+
+    // Space is only released once the data left the ring
+    __sync_synchronize();
+    fifo->ring->tail = tail + done;
+
+    return done;
+}
+
+// Completes blocked requests while there is data for readers or space for writers
+void FifoPump(fifo_t* fifo)
+{
+    uint32_t progress = 1;
+
+    while(progress)
+    {
+        progress = 0;
+
+        while((fifo->writers != NULL) && (FifoUsed(fifo) < fifo->size))
+        {
+            waiter_t* writer = fifo->writers;
+            int32_t got = FifoFill(fifo, writer->rcvid, NULL, 0, writer->done, writer->size - writer->done);
+
+            if(got < 0)
+            {
+                // Writer went away, what it wrote so far stays in the ring
+                MsgRespond(writer->rcvid, ((writer->done) ? ((int32_t)writer->done) : (-1)), NULL, 0);
+                FifoDequeue(&fifo->writers);
+                continue;
+            }
+
+            writer->done += got;
+            progress = 1;
+
+            if(writer->done < writer->size)
+            {
+                break;
+            }
+
+            MsgRespond(writer->rcvid, writer->done, NULL, 0);
+            FifoDequeue(&fifo->writers);
+        }
+
+        while((fifo->readers != NULL) && (FifoUsed(fifo) != 0))
+        {
+            waiter_t* reader = fifo->readers;
+
+            // Empty reads only wait for data, mapping readers consume it from the ring
+            int32_t got = ((reader->size) ? (FifoDrain(fifo, reader->rcvid, reader->size)) : ((int32_t)FifoUsed(fifo)));
+
+            if(got >= 0)
+            {
+                MsgRespond(reader->rcvid, got, NULL, 0);
+                progress |= (reader->size != 0);
+            }
+
+            FifoDequeue(&fifo->readers);
+        }
+    }
+}
+
+
+/* Private functions -------------------------------------- */
+
+fifo_t* FifoCreate()
+{
+    fifo_t* fifo = (fifo_t*)malloc(sizeof(fifo_t));
+
+    if(fifo == NULL)
+    {
+        return NULL;
+    }
+
+    // Header page is followed by the data so both can be shared with one object
+    fifo->ring = (fifo_hdr_t*)mmap(NULL, FIFO_PAGE_SIZE + FIFO_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANON, NOFD, 0x0);
+
+    if(fifo->ring == NULL)
+    {
+        free(fifo);
+        return NULL;
+    }
+
+    fifo->data = (char*)fifo->ring + FIFO_PAGE_SIZE;
+    fifo->size = FIFO_SIZE;
+    fifo->head = 0;
+
+    // Header tells a mapping reader the layout, only the tail is read back
+    fifo->ring->head = 0;
+    fifo->ring->tail = 0;
+    fifo->ring->size = FIFO_SIZE;
+    fifo->ring->dataOffset = FIFO_PAGE_SIZE;
+
+    MutexInit(&fifo->lock);
+    fifo->readers = NULL;
+    fifo->writers = NULL;
+
+    return fifo;
+}
+
+void FifoDelete(fifo_t* fifo)
+{
+    if(fifo == NULL)
+    {
+        return;
+    }
+
+    // Nobody can complete the requests still waiting
+    while(fifo->readers != NULL)
+    {
+        MsgRespond(fifo->readers->rcvid, -1, NULL, 0);
+        FifoDequeue(&fifo->readers);
+    }
+
+    while(fifo->writers != NULL)
+    {
+        MsgRespond(fifo->writers->rcvid, ((fifo->writers->done) ? ((int32_t)fifo->writers->done) : (-1)), NULL, 0);
+        FifoDequeue(&fifo->writers);
+    }
+
+    munmap(fifo->ring, FIFO_PAGE_SIZE + FIFO_SIZE);
+    free(fifo);
+}
+
+fifo_hdr_t* FifoRing(fifo_t* fifo)
+{
+    return fifo->ring;
+}
+
+int32_t FifoRead(fifo_t* fifo, int32_t rcvid, uint32_t size)
+{
+    MutexLock(&fifo->lock);
+
+    // Data left by writers or consumed by a mapping reader is settled first
+    FifoPump(fifo);
+
+    // Readers queued earlier are served first
+    if((fifo->readers != NULL) || (FifoUsed(fifo) == 0))
+    {
+        FifoQueue(&fifo->readers, rcvid, size, 0);
+        MutexUnlock(&fifo->lock);
+        return FIFO_DEFERRED;
+    }
+
+    int32_t ret = ((size) ? (FifoDrain(fifo, rcvid, size)) : ((int32_t)FifoUsed(fifo)));
+
+    // Freed space lets blocked writers go on
+    FifoPump(fifo);
+
+    MutexUnlock(&fifo->lock);
+
+    return ret;
+}
+
+int32_t FifoWrite(fifo_t* fifo, int32_t rcvid, const char* buffer, uint32_t received, uint32_t size)
+{
+    MutexLock(&fifo->lock);
+
+    FifoPump(fifo);
+
+    int32_t got = 0;
+
+    // Writers queued earlier keep their data ahead of this one
+    if(fifo->writers == NULL)
+    {
+        got = FifoFill(fifo, rcvid, buffer, received, 0, size);
+    }
+
+    if(got < 0)
+    {
+        MutexUnlock(&fifo->lock);
+        return -1;
+    }
+
+    if((uint32_t)got < size)
+    {
+        FifoQueue(&fifo->writers, rcvid, size, got);
+    }
+
+    // New data completes blocked readers
+    FifoPump(fifo);
+
+    MutexUnlock(&fifo->lock);
+
+    return (((uint32_t)got < size) ? (FIFO_DEFERRED) : (got));
+}
@@ -0,0 +1,43 @@
+/**
+ * @file        fifo.h
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       FIFO File Data Definition Header File
+*/
+
+#ifndef _FIFO_H_
+#define _FIFO_H_
+
+/* Includes ----------------------------------------------- */
+#include <types.h>
+#include <proc_msg.h>
+
+
+/* Exported types ----------------------------------------- */
+typedef struct Fifo fifo_t;
+
+
+/* Exported constants ------------------------------------- */
+#define FIFO_SIZE           (16 * 1024)
+
+// Request is kept and replied to once it can be completed
+#define FIFO_DEFERRED       (-100)
+
+
+/* Exported macros ---------------------------------------- */
+
+
+/* Exported functions ------------------------------------- */
+
+fifo_t* FifoCreate();
+
+void FifoDelete(fifo_t* fifo);
+
+fifo_hdr_t* FifoRing(fifo_t* fifo);
+
+int32_t FifoRead(fifo_t* fifo, int32_t rcvid, uint32_t size);
+
+int32_t FifoWrite(fifo_t* fifo, int32_t rcvid, const char* buffer, uint32_t received, uint32_t size);
+
+#endif
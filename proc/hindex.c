@@ -0,0 +1,146 @@
+/**
+ * @file        hindex.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Growable Hash Index implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <hindex.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Private types ------------------------------------------ */
+
+
+/* Private constants -------------------------------------- */
+#define HINDEX_INITIAL_SIZE     8
+#define FNV_OFFSET_BASIS        0x811C9DC5
+#define FNV_PRIME               0x01000193
+
+
+/* Private macros ----------------------------------------- */
+
+
+/* Private variables -------------------------------------- */
+
+
+/* Private function prototypes ---------------------------- */
+
+int32_t HashIndexGrow(hindex_t* index)
+{
+    uint32_t size = ((index->table == NULL) ? (HINDEX_INITIAL_SIZE) : ((index->mask + 1) << 1));
+
+    hnode_t** table = (hnode_t**)malloc(sizeof(hnode_t*) * size);
+
+    if(table == NULL)
+    {
+        return E_ERROR;
+    }
+
+    memset(table, 0x0, sizeof(hnode_t*) * size);
+
+    // Move all nodes to the new table
+    if(index->table != NULL)
+    {
+        uint32_t i;
+        for(i = 0; i <= index->mask; i++)
+        {
+            hnode_t* node = index->table[i];
+            while(node != NULL)
+            {
+                hnode_t* next = node->next;
+                node->next = table[node->hash & (size - 1)];
+                table[node->hash & (size - 1)] = node;
+                node = next;
+            }
+        }
+
+        free(index->table);
+    }
+
+    index->table = table;
+    index->mask = size - 1;
+
+    return E_OK;
+}
+
+
+/* Private functions -------------------------------------- */
+
+uint32_t HashIndexHash(const char* name, uint32_t len)
+{
+    // FNV-1a
+    uint32_t hash = FNV_OFFSET_BASIS;
+    uint32_t i;
+    for(i = 0; i < len; i++)
+    {
+        hash ^= (uint8_t)name[i];
+        hash *= FNV_PRIME;
+    }
+
+    return hash;
+}
+
+int32_t HashIndexReserve(hindex_t* index)
+{
+    // Keep load factor bellow 1, a full table only makes chains longer
+    if((index->table == NULL) || (index->count > index->mask))
+    {
+        if(HashIndexGrow(index) != E_OK && index->table == NULL)
+        {
+            return E_ERROR;
+        }
+    }
+
+    return E_OK;
+}
+
+int32_t HashIndexInsert(hindex_t* index, hnode_t* node)
+{
+    if(HashIndexReserve(index) != E_OK)
+    {
+        return E_ERROR;
+    }
+
+    hnode_t** bucket = &index->table[node->hash & index->mask];
+    node->next = *bucket;
+    *bucket = node;
+    index->count++;
+
+    return E_OK;
+}
+
+int32_t HashIndexRemove(hindex_t* index, hnode_t* node)
+{
+    if(index->table == NULL)
+    {
+        return E_INVAL;
+    }
+
+    hnode_t** it = &index->table[node->hash & index->mask];
+    for( ; *it != NULL; it = &(*it)->next)
+    {
+        if(*it == node)
+        {
+            *it = node->next;
+            node->next = NULL;
+            index->count--;
+            return E_OK;
+        }
+    }
+
+    return E_INVAL;
+}
+
+hnode_t* HashIndexBucket(hindex_t* index, uint32_t hash)
+{
+    if(index->table == NULL)
+    {
+        return NULL;
+    }
+
+    return index->table[hash & index->mask];
+}
@@ -0,0 +1,55 @@
+/**
+ * @file        hindex.h
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Growable Hash Index Definition Header File
+*/
+
+#ifndef _HINDEX_H_
+#define _HINDEX_H_
+
+/* Includes ----------------------------------------------- */
+#include <types.h>
+
+
+/* Exported types ----------------------------------------- */
+typedef struct HashNode hnode_t;
+
+struct HashNode
+{
+    hnode_t* next;
+    uint32_t hash;
+};
+
+typedef struct
+{
+    hnode_t** table;
+    uint32_t  mask;
+    uint32_t  count;
+}hindex_t;
+
+
+/* Exported constants ------------------------------------- */
+
+
+/* Exported macros ---------------------------------------- */
+
+// Get the structure that embeds a hash node
+#define HINDEX_ENTRY(node, type, member)    ((type*)((char*)(node) - offsetof(type, member)))
+
+
+/* Exported functions ------------------------------------- */
+
+uint32_t HashIndexHash(const char* name, uint32_t len);
+
+// Makes sure the next insert cannot fail
+int32_t HashIndexReserve(hindex_t* index);
+
+int32_t HashIndexInsert(hindex_t* index, hnode_t* node);
+
+int32_t HashIndexRemove(hindex_t* index, hnode_t* node);
+
+hnode_t* HashIndexBucket(hindex_t* index, uint32_t hash);
+
+#endif
@@ -0,0 +1,342 @@
+/**
+ * @file        logring.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Circular Log File Data implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <logring.h>
+#include <ipc.h>
+#include <stdlib.h>
+#include <string.h>
+
+
+/* Private types ------------------------------------------ */
+
+// Records start in a slot with their size and slot count, longer ones go on in the next slots
+// seq is 0 while the slot is being written and its sequence number plus one once it is complete
+typedef struct
+{
+    volatile uint32_t seq;
+    uint16_t size;
+    uint16_t slots;
+    char     data[LOG_SLOT_SIZE - 8];
+}slot_t;
+
+struct LogRing
+{
+    uint32_t head;
+    slot_t*  slots;
+};
+
+
+/* Private constants -------------------------------------- */
+#define LOG_SLOT_DATA       (LOG_SLOT_SIZE - 8)
+
+
+/* Private macros ----------------------------------------- */
+#define ALIGN_UP(m,a)	(((m) + (a - 1)) & (~(a - 1)))
+
+
+/* Private variables -------------------------------------- */
+
+
+/* Private function prototypes ---------------------------- */
+
+static inline slot_t* LogRingSlot(logring_t* log, uint32_t seq)
+{
+    return &log->slots[seq & (LOG_SLOTS - 1)];
+}
+
+// Record slots still hold the given sequence numbers
+static uint32_t LogRingValid(logring_t* log, uint32_t seq, uint32_t slots)
+{
+    uint32_t i;
+    for(i = 0; i < slots; i++)
+    {
+        if(LogRingSlot(log, seq + i)->seq != (seq + i + 1))
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+// Slots reserved at seq were reserved again by a writer a full ring ahead
+static inline uint32_t LogRingLapped(logring_t* log, uint32_t seq)
+{
+    return ((log->head - seq) > LOG_SLOTS);
+}
+
+// Newer records win, a writer lapped right after its check never hides the record of the slot owner
+static inline void LogRingPublish(slot_t* slot, uint32_t seq)
+{
+    uint32_t cur = slot->seq;
+
+    while(((cur == 0) || ((int32_t)(seq + 1 - cur) > 0)) && !__sync_bool_compare_and_swap(&slot->seq, cur, seq + 1))
+    {
+        cur = slot->seq;
+    }
+}
+
+// Copies client data to a record buffer, returns the bytes copied
+static uint32_t LogRingFill(char* dst, int32_t rcvid, const char* buffer, uint32_t received, uint32_t msgOffset, uint32_t size)
+{
+    uint32_t done = 0;
+
+    // Data still in the dispatcher buffer is copied, the rest is read from the client
+    if(msgOffset < received)
+    {
+        done = (((received - msgOffset) < size) ? (received - msgOffset) : (size));
+        memcpy(dst, &buffer[msgOffset], done);
+    }
+
+    if(done < size)
+    {
+        int32_t got = MsgRead(rcvid, &dst[done], size - done, msgOffset + done);
+
+        if(got > 0)
+        {
+            done += got;
+        }
+    }
+
+    return done;
+}
+
+
+/* Private functions -------------------------------------- */
+
+logring_t* LogRingCreate()
+{
+    logring_t* log = (logring_t*)malloc(sizeof(logring_t));
+
+    if(log == NULL)
+    {
+        return NULL;
+    }
+
+    log->slots = (slot_t*)malloc(LOG_SLOTS * sizeof(slot_t));
+
+    if(log->slots == NULL)
+    {
+        free(log);
+        return NULL;
+    }
+
+    // No slot holds a record yet
+    memset(log->slots, 0, LOG_SLOTS * sizeof(slot_t));
+    log->head = 0;
+
+    return log;
+}
+
+void LogRingDelete(logring_t* log)
+{
+    if(log != NULL)
+    {
+        free(log->slots);
+        free(log);
+    }
+}
+
+uint32_t LogRingHead(logring_t* log)
+{
+    return log->head;
+}
+
+int32_t LogRingAppend(logring_t* log, int32_t rcvid, const char* buffer, uint32_t received, uint32_t msgOffset, uint32_t size)
+{
+    if(size == 0)
+    {
+        return 0;
+    }
+
+    if(size > LOG_RECORD_MAX)
+    {
+        size = LOG_RECORD_MAX;
+    }
+
+    const char* data = &buffer[msgOffset];
+    char* staged = NULL;
+
+    // Data still with the client is read before reserving, a stalled client never holds slots
+    if((msgOffset + size) > received)
+    {
+        staged = (char*)malloc(size);
+
+        if(staged == NULL)
+        {
+            return -1;
+        }
+
+        // A client gone away midway leaves a shorter record
+        size = LogRingFill(staged, rcvid, buffer, received, msgOffset, size);
+        data = staged;
+
+        if(size == 0)
+        {
+            free(staged);
+            return 0;
+        }
+    }
+
+    uint32_t slots = (size + LOG_SLOT_DATA - 1) / LOG_SLOT_DATA;
+
+    // Writers never wait for each other, each one owns the slots it reserved
+    uint32_t seq = __sync_fetch_and_add(&log->head, slots);
+    uint32_t done = 0;
+    uint32_t i;
+
+    for(i = 0; i < slots; i++)
+    {
+        LogRingSlot(log, seq + i)->seq = 0;
+    }
+
+    __sync_synchronize();
+
+    for(i = 0; i < slots; i++)
+    {
+        slot_t* slot = LogRingSlot(log, seq + i);
+        uint32_t chunk = (((size - done) < LOG_SLOT_DATA) ? (size - done) : (LOG_SLOT_DATA));
+
+        memcpy(slot->data, &data[done], chunk);
+        slot->size = chunk;
+        slot->slots = 0;
+        done += chunk;
+    }
+
+    LogRingSlot(log, seq)->size = done;
+    LogRingSlot(log, seq)->slots = slots;
+
+    free(staged);
+
+    // Record is complete before readers can match its sequence numbers
+    __sync_synchronize();
+
+    // A writer that lapped this one owns the slots now, the record is dropped as if overwritten
+    if(LogRingLapped(log, seq))
+    {
+        return done;
+    }
+
+    for(i = 0; i < slots; i++)
+    {
+        LogRingPublish(LogRingSlot(log, seq + i), seq + i);
+    }
+
+    return done;
+}
+
+uint32_t LogRingRead(logring_t* log, uint32_t* seq, char* buffer, uint32_t size, uint32_t framed)
+{
+    // Entries are padded so the reply size is kept a multiple of 4
+    if(framed)
+    {
+        size &= ~3;
+
+        if(size < (sizeof(log_reply_t) + sizeof(log_entry_t)))
+        {
+            return 0;
+        }
+    }
+
+    uint32_t head = log->head;
+    uint32_t next = *seq;
+
+    __sync_synchronize();
+
+    // Sequences ahead of the head are clamped to it, overwritten ones start at the oldest slot
+    if((int32_t)(next - head) > 0)
+    {
+        next = head;
+    }
+    else if((head - next) > LOG_SLOTS)
+    {
+        next = head - LOG_SLOTS;
+    }
+
+    uint32_t first = next;
+    uint32_t start = ((framed) ? (sizeof(log_reply_t)) : (0));
+    uint32_t used = start;
+
+    // Records are returned in order, the walk stops at the first one still being written
+    while(next != head)
+    {
+        slot_t* slot = LogRingSlot(log, next);
+
+        if(slot->seq != (next + 1))
+        {
+            break;
+        }
+
+        __sync_synchronize();
+
+        uint32_t slots = slot->slots;
+        uint32_t length = slot->size;
+
+        // Start fell in the middle of an overwritten record
+        if(slots == 0)
+        {
+            next++;
+            first = ((used == start) ? (next) : (first));
+            continue;
+        }
+
+        if((slots > (LOG_RECORD_MAX / LOG_SLOT_DATA + 1)) || (length > LOG_RECORD_MAX))
+        {
+            break;
+        }
+
+        uint32_t room = size - used - ((framed) ? (sizeof(log_entry_t)) : (0));
+
+        // Only a first record too long for the reply is cut
+        if(((framed) && ((size - used) < sizeof(log_entry_t))) || ((length > room) && (used != start)))
+        {
+            break;
+        }
+
+        uint32_t copy = ((length < room) ? (length) : (room));
+        uint32_t pos = used;
+
+        if(framed)
+        {
+            log_entry_t entry = {next, copy};
+            memcpy(&buffer[pos], &entry, sizeof(log_entry_t));
+            pos += sizeof(log_entry_t);
+        }
+
+        uint32_t done = 0;
+        uint32_t i;
+        for(i = 0; (i < slots) && (done < copy); i++)
+        {
+            uint32_t chunk = (((copy - done) < LOG_SLOT_DATA) ? (copy - done) : (LOG_SLOT_DATA));
+            memcpy(&buffer[pos + done], LogRingSlot(log, next + i)->data, chunk);
+            done += chunk;
+        }
+
+        // A writer that lapped the reader meanwhile may have torn the copy
+        __sync_synchronize();
+
+        if(!LogRingValid(log, next, slots))
+        {
+            break;
+        }
+
+        used = pos + ((framed) ? (ALIGN_UP(copy, 4)) : (copy));
+        next += slots;
+    }
+
+    if(framed)
+    {
+        log_reply_t reply = {first, next};
+        memcpy(buffer, &reply, sizeof(log_reply_t));
+    }
+
+    *seq = next;
+
+    return used;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file        logring.h
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Circular Log File Data Definition Header File
+*/
+
+#ifndef _LOGRING_H_
+#define _LOGRING_H_
+
+/* Includes ----------------------------------------------- */
+#include <types.h>
+#include <proc_msg.h>
+
+
+/* Exported types ----------------------------------------- */
+typedef struct LogRing logring_t;
+
+
+/* Exported constants ------------------------------------- */
+
+// Records take whole slots, sequence numbers count slots
+#define LOG_SLOT_SIZE       64
+#define LOG_SLOTS           1024
+
+// Longer writes are cut
+#define LOG_RECORD_MAX      1024
+
+
+/* Exported macros ---------------------------------------- */
+
+
+/* Exported functions ------------------------------------- */
+
+logring_t* LogRingCreate();
+
+void LogRingDelete(logring_t* log);
+
+uint32_t LogRingHead(logring_t* log);
+
+int32_t LogRingAppend(logring_t* log, int32_t rcvid, const char* buffer, uint32_t received, uint32_t msgOffset, uint32_t size);
+
+uint32_t LogRingRead(logring_t* log, uint32_t* seq, char* buffer, uint32_t size, uint32_t framed);
+
+#endif
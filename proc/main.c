@@ -4,10 +4,10 @@
 #include <connection.h>
 #include <proc.h>
 #include <proc_io.h>
+#include <stats.h>
 
 #define PROC_SERVER_PATH    "/proc"
-#define SERVER_BUFFER_SIZE  2048
-#define SERVER_TASKS        1
+#define SERVER_TASKS        4
 
 int32_t ProcServerStart()
 {
@@ -34,6 +34,10 @@ int main()
 
     ProcFileSystemBuild();
 
+#ifdef PROC_STATS
+    StatsInit();
+#endif
+
     ProcServerStart();
 
     StdClose();
@@ -9,20 +9,54 @@
 /* Includes ----------------------------------------------- */
 #include <proc.h>
 #include <rfs.h>
+#include <dcache.h>
+#include <dedup.h>
+#include <checkpoint.h>
+#include <copy.h>
+#include <clock.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <mman.h>
+#include <ipc.h>
+#include <server.h>
 
 
 /* Private types ------------------------------------------ */
 
+// System information as answered by the system server
+typedef struct
+{
+	uint32_t ramtotal;
+	uint32_t ramavailable;
+	uint32_t ramusage;
+	uint32_t runningprocs;
+}sysinfo_t;
+
+// Inode slot, the generation changes every time the slot is reused
+typedef struct
+{
+    file_t*  file;
+    uint32_t gen;
+    uint32_t next;
+}inode_t;
+
 
 /* Private constants -------------------------------------- */
 #define FILE_ACCESS_MASK    (0x3)
 #define SYS_FILE            "/sys"
+#define MEMINFO_FILE        "/meminfo"
+#define UPTIME_FILE         "/uptime"
+#define TASKS_FILE          "/tasks"
 #define DEVICES_FILE        "/devices"
 #define BOOT_FILES_PATH     "/boot/"
+#define INODE_NONE          0xFFFFFFFF
+#define INODE_GROW          64
+#define SYS_INFO_SIZE       192
+#define GENERATED_MAX       8
+
+// Written files spread over more extents than this are merged into one on their last close
+#define FILE_COALESCE_EXTENTS   32
 
 
 /* Private macros ----------------------------------------- */
@@ -33,23 +67,101 @@
 // Proc root directory /proc/
 static dir_t root;
 
+// Protects the directory tree layout, file contents are protected per file
+static rwlock_t tree = RWLOCK_INITIALIZER;
+
+// Inode table for open by handle, protected by the tree lock
+static inode_t* inodes = NULL;
+static uint32_t ninodes = 0;
+static uint32_t freeInode = INODE_NONE;
+
+// Boot information and bytes of file data freed by unlink, rendered in /proc/sys
+static char sysInfo[SYS_INFO_SIZE];
+static size_t reclaimed = 0;
+
+// Generated files, they are created at startup and never removed
+static file_t*  generated[GENERATED_MAX];
+static uint32_t ngenerated = 0;
+
+
 
 /* Private function prototypes ---------------------------- */
 
-int32_t ProcCreateSysFile()
+int32_t ProcSysInfoGet(sysinfo_t* sysinfo)
 {
-    // Allocate memory to create the /proc/sys file
-    char* sys = (char*)malloc(sizeof(char) * 64);
+    io_hdr_t hdr;
+    hdr.type = _IO_READ;
+    hdr.code = 0;
+    hdr.sbytes = 0;
+    hdr.rbytes = sizeof(sysinfo_t);
+
+    return MsgSend(SYSTEM_SERVER, &hdr, NULL, (const char *)sysinfo, NULL);
+}
+
+size_t ProcSysRender(char* buffer, size_t size)
+{
+    (void)size;
+
+    return sprintf(buffer, "%sReclaimed: 0x%x\nDeduplicated: 0x%x\n", sysInfo, reclaimed, DedupSaved());
+}
+
+size_t ProcMeminfoRender(char* buffer, size_t size)
+{
+    (void)size;
+
+    uint32_t dirs, files;
+    size_t data;
+    ProcTreeUsage(&dirs, &files, &data);
+
+    sysinfo_t sysinfo;
+
+    // Proc data is still reported if the system server does not answer
+    if(ProcSysInfoGet(&sysinfo) != E_OK)
+    {
+        return sprintf(buffer, "ProcData: %u kB\n", data / 1024);
+    }
+
+    return sprintf(buffer, "MemTotal: %u kB\nMemAvailable: %u kB\nMemUsed: %u kB\nProcData: %u kB\n",
+                   sysinfo.ramtotal / 1024, sysinfo.ramavailable / 1024, sysinfo.ramusage / 1024, data / 1024);
+}
+
+size_t ProcUptimeRender(char* buffer, size_t size)
+{
+    (void)size;
+
+    uint32_t now = ClockMilliseconds();
+
+    return sprintf(buffer, "%u.%u%u\n", now / 1000, (now % 1000) / 100, (now % 100) / 10);
+}
 
+size_t ProcTasksRender(char* buffer, size_t size)
+{
+    (void)size;
+
+    sysinfo_t sysinfo;
+
+    if(ProcSysInfoGet(&sysinfo) != E_OK)
+    {
+        return 0;
+    }
+
+    return sprintf(buffer, "Running: %u\n", sysinfo.runningprocs);
+}
+
+int32_t ProcCreateSysFiles()
+{
     // Get Ram data
     void* ramBase = NULL;
     size_t ramSize = 0;
     RfsGetRamInfo(&ramBase, &ramSize);
 
-    // Create File
-    size_t size = sprintf(sys, "Version: %s\nArch: %s\nMach: %s\nRam Size: 0x%x\n", RfsGetVersion(), RfsGetArch(), RfsGetMach(), ramSize);
+    // Image strings are gone once it is trimmed, they are kept for /proc/sys
+    sprintf(sysInfo, "Version: %s\nArch: %s\nMach: %s\nRam Size: 0x%x\n", RfsGetVersion(), RfsGetArch(), RfsGetMach(), ramSize);
 
-    if(ProcFileCreate(NULL, SYS_FILE, sys, size, O_RDONLY, 0x0) == NULL)
+    if((ProcFileGenerated(SYS_FILE, ProcSysRender, FILE_GENERATE_TTL) == NULL) ||
+       (ProcFileGenerated(MEMINFO_FILE, ProcMeminfoRender, FILE_GENERATE_TTL) == NULL) ||
+       (ProcFileGenerated(UPTIME_FILE, ProcUptimeRender, FILE_GENERATE_TTL) == NULL) ||
+       (ProcFileGenerated(TASKS_FILE, ProcTasksRender, FILE_GENERATE_TTL) == NULL))
     {
         return E_ERROR;
     }
@@ -57,6 +169,11 @@ int32_t ProcCreateSysFile()
     return E_OK;
 }
 
+void ProcSysUpdate(size_t freed)
+{
+    __sync_fetch_and_add(&reclaimed, freed);
+}
+
 int32_t ProcCreateDevicesFile()
 {
     const size_t DEVICE_SIZE = 64;
@@ -75,7 +192,7 @@ int32_t ProcCreateDevicesFile()
         ptr += sprintf(ptr, "{\"%s\", @0x%x, 0x%x}\n", name, addr, size);
     }
 
-    if(ProcFileCreate(NULL, DEVICES_FILE, devices, (++ptr - devices), O_RDONLY, 0x0) == NULL)
+    if(ProcFileCreate(NULL, DEVICES_FILE, devices, (++ptr - devices), EXTENT_HEAP, O_RDONLY, 0x0) == NULL)
     {
         return E_ERROR;
     }
@@ -95,27 +212,79 @@ int32_t ProcCreateBootDir()
         size_t size;
         // Get Files from Raw File System
         RfsFileParse(i, &name, &type, &data, &size);
-        // Allocate Memory to copy file
-        void* dataCopy = (void*)mmap(NULL, size, (PROT_READ |PROT_WRITE), (MAP_ANON | MAP_SHARED), NOFD, 0x0);
-        // Copy file
-        memcpy(dataCopy, data, size);
         // Generate full path for file
         sprintf(path, "%s%s", BOOT_FILES_PATH, name);
 
-        if(ProcFileCreate(NULL, path, dataCopy, size, O_RDWR, FILE_MAP_PERMISSION | FILE_EXEC_PERMISSION) == NULL)
+        // File is served from the image and only copied when it gets modified
+        file_t* file = ProcFileCreate(NULL, path, data, size, EXTENT_RFS, O_RDWR, FILE_MAP_PERMISSION | FILE_EXEC_PERMISSION);
+
+        if(file == NULL)
         {
             return E_ERROR;
         }
+
+#if defined(PROC_DEDUP) && defined(PROC_DEDUP_BOOT)
+        // Boot files of a single page seed the content index, copies written later share the image page
+        ExtentsDedup(&file->extents, file->size);
+#endif
     }
 
     return E_OK;
 }
 
-void ProcDirectoryAdd(dir_t *parent, dir_t *child)
+int32_t ProcDirectoryAdd(dir_t *parent, dir_t *child)
 {
+    // Index directory by name, sibling list keeps the enumeration order
+    child->node.hash = HashIndexHash(child->name, child->len);
+
+    // Directory is only linked once it can be found by name
+    if(HashIndexInsert(&parent->dindex, &child->node) != E_OK)
+    {
+        return E_NO_RES;
+    }
+
     child->owner = parent;
     child->sibling = parent->dirs;
+    child->seq = ++parent->nseq;
     parent->dirs = child;
+
+    return E_OK;
+}
+
+dir_t* ProcDirectoryLookup(dir_t *parent, const char *name, uint32_t len)
+{
+    uint32_t hash = HashIndexHash(name, len);
+
+    hnode_t* node = HashIndexBucket(&parent->dindex, hash);
+    for( ; node != NULL; node = node->next)
+    {
+        dir_t* dir = HINDEX_ENTRY(node, dir_t, node);
+
+        if(node->hash == hash && dir->len == len && CopyEqual(name, dir->name, len))
+        {
+            return dir;
+        }
+    }
+
+    return NULL;
+}
+
+file_t* ProcFileLookup(dir_t *parent, const char *name, uint32_t len)
+{
+    uint32_t hash = HashIndexHash(name, len);
+
+    hnode_t* node = HashIndexBucket(&parent->findex, hash);
+    for( ; node != NULL; node = node->next)
+    {
+        file_t* file = HINDEX_ENTRY(node, file_t, node);
+
+        if(node->hash == hash && file->len == len && CopyEqual(name, file->name, len))
+        {
+            return file;
+        }
+    }
+
+    return NULL;
 }
 
 dir_t* ProcDirectoryCreate(dir_t *parent, char *path, char **remaining)
@@ -129,39 +298,257 @@ dir_t* ProcDirectoryCreate(dir_t *parent, char *path, char **remaining)
     }
 
     dir_t *current = (dir_t*)malloc(sizeof(dir_t) + len);
+
+    // Remaining path is cleared so callers can tell a failure from the last component
+    if(current == NULL)
+    {
+        *remaining = NULL;
+        return NULL;
+    }
+
     current->len = len;
     current->dirs = NULL;
     current->files = NULL;
+    current->nseq = 0;
+    current->dindex.table = NULL;
+    current->dindex.mask = 0;
+    current->dindex.count = 0;
+    current->findex.table = NULL;
+    current->findex.mask = 0;
+    current->findex.count = 0;
 
     memcpy(current->name, path, len);
 
-    ProcDirectoryAdd(parent, current);
+    if(ProcDirectoryAdd(parent, current) != E_OK)
+    {
+        free(current);
+        *remaining = NULL;
+        return NULL;
+    }
 
     *remaining = (path + len + 1);
 
     return current;
 }
 
-file_t* ProcFileAdd(dir_t* parent, char *name, void* data, size_t size, uint16_t access, uint16_t permission)
+void ProcInodeAlloc(file_t* file)
+{
+    if(freeInode == INODE_NONE)
+    {
+        inode_t* table = (inode_t*)realloc(inodes, sizeof(inode_t) * (ninodes + INODE_GROW));
+
+        // File still works, it just cannot be opened by handle
+        if(table == NULL)
+        {
+            file->ino = INODE_NONE;
+            file->gen = 0;
+            return;
+        }
+
+        uint32_t i;
+        for(i = ninodes; i < (ninodes + INODE_GROW); i++)
+        {
+            table[i].file = NULL;
+            table[i].gen = 0;
+            table[i].next = (((i + 1) < (ninodes + INODE_GROW)) ? (i + 1) : (INODE_NONE));
+        }
+
+        inodes = table;
+        freeInode = ninodes;
+        ninodes += INODE_GROW;
+    }
+
+    inode_t* inode = &inodes[freeInode];
+    file->ino = freeInode;
+    freeInode = inode->next;
+
+    // Generation 0 is never handed out
+    inode->gen++;
+    inode->file = file;
+    file->gen = inode->gen;
+}
+
+void ProcInodeRelease(file_t* file)
+{
+    if(file->ino == INODE_NONE)
+    {
+        return;
+    }
+
+    inode_t* inode = &inodes[file->ino];
+    inode->file = NULL;
+    inode->next = freeInode;
+    freeInode = file->ino;
+}
+
+int32_t ProcFileAttach(dir_t* parent, file_t* file)
+{
+    file->node.hash = HashIndexHash(file->name, file->len);
+
+    // File is only linked once it can be found by name
+    if(HashIndexInsert(&parent->findex, &file->node) != E_OK)
+    {
+        return E_NO_RES;
+    }
+
+    file->owner = parent;
+    file->sibling = parent->files;
+    file->seq = ++parent->nseq;
+    parent->files = file;
+
+    return E_OK;
+}
+
+int32_t ProcFileDetach(file_t* file)
+{
+    dir_t* parent = file->owner;
+
+    if(parent->files == file)
+    {
+        parent->files = file->sibling;
+    }
+    else
+    {
+        file_t* it;
+        for(it = parent->files; it != NULL; it = it->sibling)
+        {
+            if(it->sibling == file)
+            {
+                it->sibling = file->sibling;
+                break;
+            }
+        }
+
+        if(it == NULL)
+        {
+            return E_INVAL;
+        }
+    }
+
+    HashIndexRemove(&parent->findex, &file->node);
+
+    return E_OK;
+}
+
+file_t* ProcFileAlloc(const char *name, void* data, size_t size, uint32_t origin, uint16_t access, uint16_t permission)
 {
     uint32_t len = strlen(name);
     file_t* file = (file_t*)malloc(sizeof(file_t) + len);
-    file->owner = parent;
+
+    if(file == NULL)
+    {
+        return NULL;
+    }
+
+    // Data stays with the caller if the file cannot be added
+    if(ExtentsInit(&file->extents, data, size, origin) != E_OK)
+    {
+        free(file);
+        return NULL;
+    }
+
     file->refs = 0;
+    file->maps = 0;
     file->size = size;
-    file->data = data;
     file->access = access;
     file->permission = permission;
+    file->dirty = 0;
     file->len = len;
+    RwLockInit(&file->lock);
+    // Name is stored after the file until a rename needs a longer one
+    file->name = (char*)(file + 1);
+    file->generate = NULL;
+    file->ttl = 0;
+    file->stamp = 0;
+    file->fifo = NULL;
+    file->log = NULL;
     memcpy(file->name, name, len);
-    file->sibling = parent->files;
-    parent->files = file;
 
     return file;
 }
 
+file_t* ProcFileAdd(dir_t* parent, char *name, void* data, size_t size, uint32_t origin, uint16_t access, uint16_t permission)
+{
+    file_t* file = ProcFileAlloc(name, data, size, origin, access, permission);
+
+    if(file == NULL)
+    {
+        return NULL;
+    }
+
+    if(ProcFileAttach(parent, file) != E_OK)
+    {
+        free(file->extents.first);
+        free(file);
+        return NULL;
+    }
+
+    ProcInodeAlloc(file);
+
+    return file;
+}
+
+void ProcFileRelease(file_t* file)
+{
+    // Data still shared with other files is not reclaimed yet
+    size_t freed = ExtentsFree(&file->extents);
+    FifoDelete(file->fifo);
+    LogRingDelete(file->log);
+
+    if(file->name != (char*)(file + 1))
+    {
+        free(file->name);
+    }
+
+    free(file);
+
+    ProcSysUpdate(freed);
+}
+
+void ProcDirUsage(dir_t* dir, uint32_t* dirs, uint32_t* files, size_t* data)
+{
+    file_t* file = dir->files;
+    for( ; file != NULL; file = file->sibling)
+    {
+        (*files)++;
+        *data += file->extents.capacity;
+    }
+
+    dir_t* child = dir->dirs;
+    for( ; child != NULL; child = child->sibling)
+    {
+        (*dirs)++;
+        ProcDirUsage(child, dirs, files, data);
+    }
+}
+
 /* Private functions -------------------------------------- */
 
+int32_t ProcRestoreCheckpoint()
+{
+    uint32_t i;
+    for(i = 0; i < RfsDevicesCount(); i++)
+    {
+        char* name;
+        void* addr;
+        size_t size;
+        RfsDeviceParse(i, &name, &addr, &size);
+
+        // Checkpoint lives in a reserved memory region declared as a device
+        if((name != NULL) && !strcmp(name, CHECKPOINT_DEVICE))
+        {
+            if(CheckpointInit(addr, size) != E_OK)
+            {
+                return E_ERROR;
+            }
+
+            return CheckpointRestore();
+        }
+    }
+
+    return E_NO_RES;
+}
+
 int32_t ProcFileSystemBuild()
 {
     // Get and parse Raw File System
@@ -172,17 +559,45 @@ int32_t ProcFileSystemBuild()
 
     int32_t ret = E_OK;
 
-    if((RfsParse() != E_OK) || (ProcCreateSysFile() != E_OK) || (ProcCreateDevicesFile() != E_OK) || (ProcCreateBootDir() != E_OK))
+    if((RfsParse() != E_OK) || (ProcCreateSysFiles() != E_OK) || (ProcCreateDevicesFile() != E_OK) || (ProcCreateBootDir() != E_OK))
     {
         ret = E_ERROR;
     }
 
-    // No longer needed so release memory
-    RfsDelete();
+    // A missing or empty checkpoint just leaves /proc/user empty
+    if(ret == E_OK)
+    {
+        ProcRestoreCheckpoint();
+    }
+
+    // Keep only the image pages used by /boot files
+    if(ret == E_OK)
+    {
+        RfsTrim();
+    }
+    else
+    {
+        RfsDelete();
+    }
 
     return ret;
 }
 
+void ProcTreeRead()
+{
+    RwLockRead(&tree);
+}
+
+void ProcTreeWrite()
+{
+    RwLockWrite(&tree);
+}
+
+void ProcTreeUnlock()
+{
+    RwLockUnlock(&tree);
+}
+
 dir_t* ProcPathResolve(dir_t* cwd, const char* path, char** remaining)
 {
     dir_t *parent = cwd;
@@ -217,13 +632,7 @@ dir_t* ProcPathResolve(dir_t* cwd, const char* path, char** remaining)
         uint32_t len = 0;
         for( ; ptr[len] && ('/' != ptr[len]); len++) {}
         
-        for(current = parent->dirs; current != NULL; current = current->sibling)
-        {
-            if(current->len == len && !memcmp(ptr, current->name, len))
-            {
-                break;
-            }
-        }
+        current = ProcDirectoryLookup(parent, ptr, len);
 
         if(current == NULL)
         {
@@ -243,7 +652,34 @@ dir_t* ProcPathResolve(dir_t* cwd, const char* path, char** remaining)
     return parent;
 }
 
-file_t* ProcFileGet(dir_t* cwd, const char* path)
+dir_t* ProcDirGet(dir_t* cwd, const char* path)
+{
+    void* cached;
+
+    // Only full paths are cached
+    if(cwd == NULL && DcacheLookup(path, DCACHE_DIR, &cached) == E_OK)
+    {
+        return (dir_t*)cached;
+    }
+
+    char* remaining = NULL;
+    dir_t* dir = ProcPathResolve(cwd, path, &remaining);
+
+    // Path was not fully resolved
+    if(remaining != NULL)
+    {
+        return NULL;
+    }
+
+    if(cwd == NULL)
+    {
+        DcacheInsert(path, DCACHE_DIR, dir);
+    }
+
+    return dir;
+}
+
+file_t* ProcFileResolve(dir_t* cwd, const char* path)
 {
     // Get path length
     uint32_t length = strlen(path);
@@ -274,19 +710,95 @@ file_t* ProcFileGet(dir_t* cwd, const char* path)
     }
 
     // Search for the server in the name space
-    file_t *file;
-    for(file = parent->files; file != NULL; file = file->sibling)
+    return ProcFileLookup(parent, remaining, length);
+}
+
+file_t* ProcFileGet(dir_t* cwd, const char* path)
+{
+    void* cached;
+
+    // Only full paths are cached, misses are cached as negative entries
+    if(cwd == NULL && DcacheLookup(path, DCACHE_FILE, &cached) == E_OK)
     {
-        if(file->len == length && !memcmp(remaining, file->name, length))
+        return (file_t*)cached;
+    }
+
+    file_t* file = ProcFileResolve(cwd, path);
+
+    if(cwd == NULL)
+    {
+        DcacheInsert(path, ((file != NULL) ? (DCACHE_FILE) : (DCACHE_NEGATIVE)), file);
+    }
+
+    return file;
+}
+
+dir_t* ProcDirNext(dir_t* cwd, uint32_t seq, uint32_t hash)
+{
+    // Start of listing
+    if(seq == 0)
+    {
+        return cwd->dirs;
+    }
+
+    // Children are added at the head of the list so the cursor entry is found by its hash
+    hnode_t* node = HashIndexBucket(&cwd->dindex, hash);
+    for( ; node != NULL; node = node->next)
+    {
+        dir_t* dir = HINDEX_ENTRY(node, dir_t, node);
+
+        if(dir->seq == seq)
         {
-            return file;
+            return dir->sibling;
         }
     }
 
-    return NULL;
+    // Cursor entry is gone, resume at the first older entry
+    dir_t* dir = cwd->dirs;
+    for( ; dir != NULL && dir->seq >= seq; dir = dir->sibling) {}
+
+    return dir;
+}
+
+file_t* ProcFileNext(dir_t* cwd, uint32_t seq, uint32_t hash)
+{
+    // Start of listing
+    if(seq == 0)
+    {
+        return cwd->files;
+    }
+
+    // Children are added at the head of the list so the cursor entry is found by its hash
+    hnode_t* node = HashIndexBucket(&cwd->findex, hash);
+    for( ; node != NULL; node = node->next)
+    {
+        file_t* file = HINDEX_ENTRY(node, file_t, node);
+
+        if(file->seq == seq)
+        {
+            return file->sibling;
+        }
+    }
+
+    // Cursor entry is gone, resume at the first older entry
+    file_t* file = cwd->files;
+    for( ; file != NULL && file->seq >= seq; file = file->sibling) {}
+
+    return file;
 }
 
-file_t* ProcFileCreate(dir_t* cwd, const char *path, void* data, size_t size, uint16_t access, uint16_t permission)
+file_t* ProcFileGetHandle(uint32_t ino, uint32_t gen)
+{
+    // Deleted or recreated files do not match the generation
+    if((ino >= ninodes) || (inodes[ino].file == NULL) || (inodes[ino].gen != gen))
+    {
+        return NULL;
+    }
+
+    return inodes[ino].file;
+}
+
+file_t* ProcFileCreate(dir_t* cwd, const char *path, void* data, size_t size, uint32_t origin, uint16_t access, uint16_t permission)
 {
     // Get path length
     uint32_t length = strlen(path);
@@ -297,6 +809,14 @@ file_t* ProcFileCreate(dir_t* cwd, const char *path, void* data, size_t size, ui
         return NULL;
     }
 
+    // File may have been created since the caller looked it up
+    file_t* file = ProcFileResolve(cwd, path);
+
+    if(file != NULL)
+    {
+        return file;
+    }
+
     // Get the last namespace in the specified path
     char *remaining;
     dir_t* parent = ProcPathResolve(cwd, path, &remaining);
@@ -322,42 +842,294 @@ file_t* ProcFileCreate(dir_t* cwd, const char *path, void* data, size_t size, ui
         parent = current;
     }
     
-    // At this point we only have the name of the server left
-    return ProcFileAdd(parent, remaining, data, size, access, permission);
+    // At this point we only have the name of the server left, unless a directory could not be created
+    file = ((remaining != NULL) ? (ProcFileAdd(parent, remaining, data, size, origin, access, permission)) : (NULL));
+
+    // Cached misses may now resolve to this file
+    DcacheInvalidateNegative();
+
+    return file;
+}
+
+file_t* ProcFileGenerated(const char* path, generator_t generate, uint32_t ttl)
+{
+    if(ngenerated >= GENERATED_MAX)
+    {
+        return NULL;
+    }
+
+    file_t* file = ProcFileCreate(NULL, path, NULL, 0, EXTENT_HEAP, O_RDONLY, 0x0);
+
+    if(file != NULL)
+    {
+        file->generate = generate;
+        file->ttl = ttl;
+        generated[ngenerated++] = file;
+    }
+
+    return file;
+}
+
+void ProcFileGenerateAll()
+{
+    uint32_t i;
+    for(i = 0; i < ngenerated; i++)
+    {
+        ProcFileGenerate(generated[i]);
+    }
+}
+
+int32_t ProcFileGenerate(file_t* file)
+{
+    uint32_t now = ClockMilliseconds();
+
+    // Contents rendered a moment ago are served again, polling readers do not render every time
+    // Without a running clock every read renders
+    RwLockRead(&file->lock);
+    uint32_t fresh = ((now != 0) && (file->size != 0) && ((now - file->stamp) < file->ttl));
+    RwLockUnlock(&file->lock);
+
+    if(fresh)
+    {
+        return E_OK;
+    }
+
+    char* data = (char*)malloc(FILE_GENERATE_SIZE);
+
+    // Readers keep the previous contents if there is no memory
+    if(data == NULL)
+    {
+        return E_NO_RES;
+    }
+
+    size_t size = file->generate(data, FILE_GENERATE_SIZE);
+
+    RwLockWrite(&file->lock);
+
+    // Mapped contents are left alone
+    if(file->maps == 0)
+    {
+        ExtentsFree(&file->extents);
+        ExtentsInit(&file->extents, data, size, EXTENT_HEAP);
+        file->size = size;
+        file->stamp = now;
+        // Empty contents leave the buffer unused
+        data = ((size == 0) ? (data) : (NULL));
+    }
+
+    RwLockUnlock(&file->lock);
+
+    free(data);
+
+    return E_OK;
+}
+
+void ProcTreeUsage(uint32_t* dirs, uint32_t* files, size_t* data)
+{
+    *dirs = 0;
+    *files = 0;
+    *data = 0;
+
+    // File capacities are sampled without their locks
+    ProcTreeRead();
+    ProcDirUsage(&root, dirs, files, data);
+    ProcTreeUnlock();
 }
 
 int32_t ProcFileDelete(file_t* file)
 {
-    if(file->refs > 0)
+    if(ProcFileDetach(file) != E_OK)
+    {
+        return E_INVAL;
+    }
+
+    DcacheInvalidateObject(file);
+    ProcInodeRelease(file);
+
+    // Openers and mappers keep the data, the last close frees it
+    RwLockWrite(&file->lock);
+    file->owner = NULL;
+    uint16_t refs = file->refs;
+    RwLockUnlock(&file->lock);
+
+    if(refs == 0)
+    {
+        ProcFileRelease(file);
+    }
+
+    return E_OK;
+}
+
+int32_t ProcFileRename(file_t* file, const char* path)
+{
+    uint32_t length = strlen(path);
+
+    // Last character has to be different from '/'
+    if((length == 0) || (path[length - 1] == '/'))
+    {
+        return E_INVAL;
+    }
+
+    file_t* target = ProcFileResolve(NULL, path);
+
+    if(target == file)
+    {
+        return E_OK;
+    }
+
+    // Path names a directory
+    if((target == NULL) && (ProcDirGet(NULL, path) != NULL))
+    {
+        return E_INVAL;
+    }
+
+    // File name is whatever follows the last '/'
+    const char* base = path + length;
+    for( ; (base != path) && (base[-1] != '/'); base--) {}
+
+    uint32_t len = strlen(base);
+    char* name = file->name;
+
+    // A longer name no longer fits where the old one was stored
+    if(len > file->len)
+    {
+        name = (char*)malloc(len);
+
+        if(name == NULL)
+        {
+            return E_NO_RES;
+        }
+    }
+
+    char *remaining;
+    dir_t* parent = ProcPathResolve(NULL, path, &remaining);
+
+    // Create directories if required
+    while(1)
+    {
+        dir_t *current = ProcDirectoryCreate(parent, remaining, &remaining);
+
+        if(current == NULL)
+        {
+            break;
+        }
+
+        parent = current;
+    }
+
+    // File is only moved once the new directory can index it
+    if((remaining == NULL) || (HashIndexReserve(&parent->findex) != E_OK))
+    {
+        if(name != file->name)
+        {
+            free(name);
+        }
+
+        return E_NO_RES;
+    }
+
+    // Replacing drops the old file only once the move cannot fail, its data goes when its last user does
+    if(target != NULL)
+    {
+        ProcFileDelete(target);
+    }
+
+    if((name != file->name) && (file->name != (char*)(file + 1)))
+    {
+        free(file->name);
+    }
+
+    // Data is not touched, only the directory entry moves
+    ProcFileDetach(file);
+    DcacheInvalidateObject(file);
+
+    memcpy(name, remaining, len);
+    file->name = name;
+    file->len = len;
+
+    // Index room was reserved above, attaching cannot fail
+    ProcFileAttach(parent, file);
+
+    // Cached misses may now resolve to this file
+    DcacheInvalidateNegative();
+
+    return E_OK;
+}
+
+int32_t ProcFileClone(file_t* file, const char* path)
+{
+    file_t* target = ProcFileResolve(NULL, path);
+
+    if((target == file) || ((target == NULL) && (ProcDirGet(NULL, path) != NULL)))
+    {
+        return E_INVAL;
+    }
+
+    // Pages mapped by clients can change behind the server's back
+    RwLockRead(&file->lock);
+    uint16_t maps = file->maps;
+    RwLockUnlock(&file->lock);
+
+    if(maps > 0)
     {
         return E_BUSY;
     }
 
-    dir_t* parent = file->owner;
-    
-    if(parent->files == file)
+    file_t* clone;
+
+    if(target == NULL)
     {
-        parent->files = file->sibling;
+        clone = ProcFileCreate(NULL, path, NULL, 0, EXTENT_ANON, O_RDWR, file->permission);
     }
     else
     {
-        file_t* it;
-        for(it = parent->files; it != NULL; it = it->sibling)
+        // File name is whatever follows the last '/'
+        const char* base = path + strlen(path);
+        for( ; (base != path) && (base[-1] != '/'); base--) {}
+
+        // Replacement is built unlinked, the old file stays in place until the clone is complete
+        clone = ProcFileAlloc(base, NULL, 0, EXTENT_ANON, O_RDWR, file->permission);
+
+        if((clone != NULL) && (HashIndexReserve(&target->owner->findex) != E_OK))
         {
-            if(it->sibling == file)
-            {
-                it->sibling = file->sibling;
-                break;
-            }
+            ProcFileRelease(clone);
+            return E_NO_RES;
         }
+    }
 
-        if(it == NULL)
+    if(clone == NULL)
+    {
+        return E_INVAL;
+    }
+
+    // Both files share the data until one of them writes it
+    RwLockWrite(&file->lock);
+    int32_t ret = ExtentsClone(&clone->extents, &file->extents);
+    clone->size = file->size;
+    RwLockUnlock(&file->lock);
+
+    if(ret != E_OK)
+    {
+        if(target == NULL)
         {
-            return E_INVAL;
+            ProcFileDelete(clone);
         }
+        else
+        {
+            ProcFileRelease(clone);
+        }
+
+        return E_NO_RES;
+    }
+
+    if(target != NULL)
+    {
+        // Old file's data goes when its last user does, index room was reserved above
+        dir_t* parent = target->owner;
+        ProcFileDelete(target);
+        ProcFileAttach(parent, clone);
+        ProcInodeAlloc(clone);
     }
-    
-    free(file);
 
     return E_OK;
 }
@@ -366,7 +1138,9 @@ int32_t ProcFileOpen(file_t* file, int32_t mode)
 {
     if(mode == O_RDONLY || file->access & (uint16_t)(mode & FILE_ACCESS_MASK))
     {
+        RwLockWrite(&file->lock);
         file->refs++;
+        RwLockUnlock(&file->lock);
         return E_OK;
     }
 
@@ -375,5 +1149,32 @@ int32_t ProcFileOpen(file_t* file, int32_t mode)
 
 int32_t ProcFileClose(file_t* file)
 {
-    return --file->refs;
+    RwLockWrite(&file->lock);
+    int32_t refs = --file->refs;
+    // Unlinked files are freed by their last user
+    uint32_t release = ((refs == 0) && (file->owner == NULL));
+
+#ifdef PROC_DEDUP
+    // Written files share identical pages once nobody has them open or mapped
+    if((refs == 0) && (!release) && (file->dirty) && (file->maps == 0))
+    {
+        // Small files stay in pages, only a long extent list is worth a copy
+        if(file->extents.count > FILE_COALESCE_EXTENTS)
+        {
+            ExtentsCoalesce(&file->extents);
+        }
+
+        ExtentsDedup(&file->extents, file->size);
+        file->dirty = 0;
+    }
+#endif
+
+    RwLockUnlock(&file->lock);
+
+    if(release)
+    {
+        ProcFileRelease(file);
+    }
+
+    return refs;
 }
@@ -12,18 +12,31 @@
 /* Includes ----------------------------------------------- */
 #include <types.h>
 #include <fcntl.h>
+#include <hindex.h>
+#include <rwlock.h>
+#include <extent.h>
+#include <fifo.h>
+#include <logring.h>
 
 
 /* Exported types ----------------------------------------- */
 typedef struct Directory dir_t;
 typedef struct File file_t;
 
+// Renders the contents of a generated file, returns the bytes written
+typedef size_t (*generator_t)(char* buffer, size_t size);
+
 struct Directory
 {
 	dir_t*   owner;
 	dir_t*   sibling;
 	dir_t*   dirs;
 	file_t*  files;
+	hnode_t  node;
+	hindex_t dindex;
+	hindex_t findex;
+	uint32_t seq;
+	uint32_t nseq;
 	uint16_t refs;
 	uint16_t len;
 	char name[1];
@@ -33,13 +46,25 @@ struct File
 {
 	dir_t*   owner;
 	file_t*  sibling;
+	hnode_t  node;
+	uint32_t seq;
+	uint32_t ino;
+	uint32_t gen;
+	rwlock_t lock;
     size_t   size;
-    void*    data;
+    extents_t extents;
     uint16_t refs;
+    uint16_t maps;
 	uint16_t access;
     uint16_t permission;
+    uint16_t dirty;
 	uint16_t len;
-	char     name[1];
+	char*    name;
+    generator_t generate;
+    uint32_t ttl;       // Milliseconds generated contents are reused
+    uint32_t stamp;     // Clock milliseconds of the last rendering
+    fifo_t*  fifo;      // FIFO files keep their data in a ring instead of the extents
+    logring_t* log;     // Circular logs keep their records in fixed slots
 };
 
 
@@ -47,6 +72,10 @@ struct File
 #define FILE_EXEC_PERMISSION    1
 #define FILE_MAP_PERMISSION     2
 
+// Largest contents of a generated file and default time they are reused for
+#define FILE_GENERATE_SIZE      4096
+#define FILE_GENERATE_TTL       100
+
 
 /* Exported macros ---------------------------------------- */
 
@@ -55,14 +84,42 @@ struct File
 
 int32_t ProcFileSystemBuild();
 
+void ProcTreeRead();
+
+void ProcTreeWrite();
+
+void ProcTreeUnlock();
+
+// Lookups require the tree read lock, creation and deletion the tree write lock
 dir_t* ProcPathResolve(dir_t* cwd, const char* path, char** remaining);
 
+dir_t* ProcDirGet(dir_t* cwd, const char* path);
+
 file_t* ProcFileGet(dir_t* cwd, const char* path);
 
-file_t* ProcFileCreate(dir_t* cwd, const char *path, void* data, size_t size, uint16_t access, uint16_t permission);
+dir_t* ProcDirNext(dir_t* cwd, uint32_t seq, uint32_t hash);
+
+file_t* ProcFileNext(dir_t* cwd, uint32_t seq, uint32_t hash);
+
+file_t* ProcFileGetHandle(uint32_t ino, uint32_t gen);
+
+file_t* ProcFileCreate(dir_t* cwd, const char *path, void* data, size_t size, uint32_t origin, uint16_t access, uint16_t permission);
+
+file_t* ProcFileGenerated(const char* path, generator_t generate, uint32_t ttl);
+
+int32_t ProcFileGenerate(file_t* file);
+
+// Renders stale generated files so listings report their current size, called without the tree lock
+void ProcFileGenerateAll();
+
+void ProcTreeUsage(uint32_t* dirs, uint32_t* files, size_t* data);
 
 int32_t ProcFileDelete(file_t* file);
 
+int32_t ProcFileRename(file_t* file, const char* path);
+
+int32_t ProcFileClone(file_t* file, const char* path);
+
 int32_t ProcFileOpen(file_t* file, int32_t mode);
 
 int32_t ProcFileClose(file_t* file);
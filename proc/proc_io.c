@@ -9,11 +9,17 @@
 /* Includes ----------------------------------------------- */
 #include <proc_io.h>
 #include <proc.h>
+#include <dcache.h>
 #include <ipc.h>
 #include <server.h>
 #include <string.h>
 #include <mman.h>
 #include <unistd.h>
+#include <rwlock.h>
+#include <ring.h>
+#include <checkpoint.h>
+#include <stats.h>
+#include <trace.h>
 
 
 /* Private types ------------------------------------------ */
@@ -22,232 +28,1447 @@
 /* Private constants -------------------------------------- */
 #define FILE_DEFAULT_SIZE   4096
 #define FILE_ACCESS_MASK    (0x3)
+#define FILE_WRITE_STEP     (64 * 1024)
+#define FILE_SIZE_MAX       (0xFFFFFFFF)
 
 
 /* Private macros ----------------------------------------- */
 #define ALIGN_DOWN(m,a)	((m) & (~(a - 1)))
 #define ALIGN_UP(m,a)	(((m) + (a - 1)) & (~(a - 1)))
 
+// Every reply is accounted to the request being served
+#define MsgRespond(rcvid, status, buffer, size)     ProcRespond(rcvid, status, buffer, size)
+#define MsgWrite(rcvid, buffer, size, offset)       ProcMsgWrite(rcvid, buffer, size, offset)
+
 /* Private variables -------------------------------------- */
 
 
 
 /* Private function prototypes ---------------------------- */
 
-uint32_t CopyDirEntries(char* buffer, dir_t* cwd)
+void ProcRequest(int32_t rcvid, int32_t scoid, connect_t* con, io_hdr_t* hdr, uint32_t op)
+{
+#ifdef PROC_STATS
+    StatsBegin(rcvid, con, op);
+#else
+    (void)con; (void)op;
+#endif
+
+    TraceBegin(rcvid, scoid, hdr);
+}
+
+int32_t ProcRespond(int32_t rcvid, int32_t status, const char* buffer, uint32_t size)
+{
+#ifdef PROC_STATS
+    StatsEnd(rcvid, status, size);
+#endif
+
+    TraceEnd(rcvid, status, size);
+
+    // Parentheses keep the real function from being replaced by the macro
+    return (MsgRespond)(rcvid, status, buffer, size);
+}
+
+// Reply data sent ahead of the reply is accounted to the request
+int32_t ProcMsgWrite(int32_t rcvid, const char* buffer, uint32_t size, uint32_t offset)
+{
+    int32_t ret = (MsgWrite)(rcvid, buffer, size, offset);
+
+#ifdef PROC_STATS
+    if(ret > 0)
+    {
+        StatsWritten(rcvid, ret);
+    }
+#endif
+
+    return ret;
+}
+
+// Request is replied to later, accounting ends when it is handed over
+void ProcDefer(int32_t rcvid)
+{
+#ifdef PROC_STATS
+    StatsEnd(rcvid, E_OK, 0);
+#endif
+
+    TraceEnd(rcvid, E_OK, 0);
+}
+
+uint32_t CopyDirEntry(char* buffer, dir_t* dir)
+{
+    uint32_t size = 0;
+    dentry_t dentry = {INFO_DIR, (uint16_t)dir->len};
+    memcpy(&buffer[size], &dentry, offsetof(dentry_t, name));
+    size += offsetof(dentry_t, name);
+    memcpy(&buffer[size], dir->name, dir->len);
+    size += dir->len + 1;
+    buffer[size - 1] = 0;
+
+    return size;
+}
+
+uint32_t CopyFileEntry(char* buffer, file_t* file)
+{
+    uint32_t size = 0;
+    fentry_t fentry = {INFO_FILE, file->size, (uint16_t)file->len};
+
+    memcpy(&buffer[size], &fentry, offsetof(fentry_t, name));
+    size += offsetof(fentry_t, name);
+    memcpy(&buffer[size], file->name, file->len);
+    size += file->len + 1;
+    buffer[size - 1] = 0;
+
+    return size;
+}
+
+// Directories then files are copied until the first entry that does not fit in limit bytes
+uint32_t CopyEntries(char* buffer, dir_t* cwd, uint32_t limit)
 {
     uint32_t size = 0;
     dir_t* dir = cwd->dirs;
     for( ; dir != NULL; dir = dir->sibling)
     {
-        dentry_t dentry = {INFO_DIR, (uint16_t)dir->len};
-        memcpy(&buffer[size], &dentry, offsetof(dentry_t, name));
-        size += offsetof(dentry_t, name);
-        memcpy(&buffer[size], dir->name, dir->len);
-        size += dir->len + 1;
-        buffer[size - 1] = 0;
+        if((size + offsetof(dentry_t, name) + dir->len + 1) > limit)
+        {
+            return size;
+        }
+
+        size += CopyDirEntry(&buffer[size], dir);
+    }
+
+    file_t* file = cwd->files;
+    for( ; file != NULL; file = file->sibling)
+    {
+        if((size + offsetof(fentry_t, name) + file->len + 1) > limit)
+        {
+            return size;
+        }
+
+        size += CopyFileEntry(&buffer[size], file);
+    }
+
+    return size;
+}
+
+int32_t ProcInfoListPage(int32_t rcvid, io_hdr_t* hdr, char* buffer, uint32_t offset)
+{
+    // Request holds the cursor followed by the directory path
+    if((offset <= sizeof(list_cursor_t)) || (offset >= SERVER_BUFFER_SIZE) || (hdr->rbytes < sizeof(list_page_t)))
+    {
+        return MsgRespond(rcvid, E_INVAL, NULL, 0);
+    }
+
+    list_page_t page;
+    memcpy(&page.next, buffer, sizeof(list_cursor_t));
+    page.size = 0;
+
+    // In case sender did not put a terminator character
+    buffer[offset] = 0;
+
+    // Generated files report the size of their current contents
+    ProcFileGenerateAll();
+
+    ProcTreeRead();
+
+    dir_t* cwd = ProcDirGet(NULL, &buffer[sizeof(list_cursor_t)]);
+
+    if(cwd == NULL)
+    {
+        ProcTreeUnlock();
+        return MsgRespond(rcvid, E_INVAL, NULL, 0);
+    }
+
+    // Entries are staged in the dispatcher buffer and written straight to the client reply
+    uint32_t budget = hdr->rbytes - sizeof(list_page_t);
+    uint32_t staged = 0;
+    list_cursor_t* cursor = &page.next;
+
+    if(cursor->phase == LIST_CURSOR_DIRS)
+    {
+        dir_t* dir = ProcDirNext(cwd, cursor->seq, cursor->hash);
+        for( ; dir != NULL; dir = dir->sibling)
+        {
+            uint32_t size = offsetof(dentry_t, name) + dir->len + 1;
+
+            if((page.size + staged + size) > budget)
+            {
+                break;
+            }
+
+            if((staged + size) > SERVER_BUFFER_SIZE)
+            {
+                MsgWrite(rcvid, buffer, staged, sizeof(list_page_t) + page.size);
+                page.size += staged;
+                staged = 0;
+            }
+
+            staged += CopyDirEntry(&buffer[staged], dir);
+            cursor->seq = dir->seq;
+            cursor->hash = dir->node.hash;
+        }
+
+        if(dir == NULL)
+        {
+            cursor->phase = LIST_CURSOR_FILES;
+            cursor->seq = 0;
+            cursor->hash = 0;
+        }
+    }
+
+    if(cursor->phase == LIST_CURSOR_FILES)
+    {
+        file_t* file = ProcFileNext(cwd, cursor->seq, cursor->hash);
+        for( ; file != NULL; file = file->sibling)
+        {
+            uint32_t size = offsetof(fentry_t, name) + file->len + 1;
+
+            if((page.size + staged + size) > budget)
+            {
+                break;
+            }
+
+            if((staged + size) > SERVER_BUFFER_SIZE)
+            {
+                MsgWrite(rcvid, buffer, staged, sizeof(list_page_t) + page.size);
+                page.size += staged;
+                staged = 0;
+            }
+
+            staged += CopyFileEntry(&buffer[staged], file);
+            cursor->seq = file->seq;
+            cursor->hash = file->node.hash;
+        }
+
+        if(file == NULL)
+        {
+            cursor->phase = LIST_CURSOR_END;
+        }
+    }
+
+    ProcTreeUnlock();
+
+    if(staged > 0)
+    {
+        MsgWrite(rcvid, buffer, staged, sizeof(list_page_t) + page.size);
+        page.size += staged;
+    }
+
+    return MsgRespond(rcvid, E_OK, (const char*)&page, sizeof(list_page_t));
+}
+
+int32_t ProcInfoMultiGet(int32_t rcvid, io_hdr_t* hdr, char* buffer, uint32_t offset)
+{
+    // Request holds a list of paths separated by terminator characters, half the buffer is kept for staging
+    if((offset == 0) || (offset >= (SERVER_BUFFER_SIZE / 2)) || (hdr->rbytes < sizeof(mget_reply_t)))
+    {
+        return MsgRespond(rcvid, E_INVAL, NULL, 0);
+    }
+
+    // In case sender did not put a terminator character
+    buffer[offset] = 0;
+
+    mget_reply_t reply = {0, 0};
+
+    // Records are staged in the free space after the request, file data too big for it is written straight from the extents
+    char* stage = &buffer[offset + 1];
+    uint32_t stageSize = SERVER_BUFFER_SIZE - (offset + 1);
+    uint32_t staged = 0;
+    uint32_t budget = hdr->rbytes - sizeof(mget_reply_t);
+
+    char* path = buffer;
+    for( ; path < &buffer[offset]; path += strlen(path) + 1)
+    {
+        uint32_t len = strlen(path);
+
+        if(len == 0)
+        {
+            continue;
+        }
+
+        uint32_t head = sizeof(mget_record_t) + offsetof(fentry_t, name) + len + 1;
+
+        // Remaining paths are left for the next request
+        if(((reply.size + staged + head) > budget) || (head > stageSize))
+        {
+            break;
+        }
+
+        if((staged + head) > stageSize)
+        {
+            MsgWrite(rcvid, stage, staged, sizeof(mget_reply_t) + reply.size);
+            reply.size += staged;
+            staged = 0;
+        }
+
+        mget_record_t record = {E_NO_RES, 0};
+        fentry_t fentry = {INFO_FILE, 0, (uint16_t)len};
+
+        ProcTreeRead();
+
+        file_t* file = ProcFileGet(NULL, path);
+
+        // The file lock keeps the data valid once the tree is released
+        if((file != NULL) && (file->generate == NULL))
+        {
+            RwLockRead(&file->lock);
+        }
+
+        ProcTreeUnlock();
+
+        // Generated files are never removed, renderers may take the tree lock themselves
+        if((file != NULL) && (file->generate != NULL))
+        {
+            ProcFileGenerate(file);
+            RwLockRead(&file->lock);
+        }
+
+        if(file != NULL)
+        {
+            record.status = E_OK;
+            fentry.size = file->size;
+        }
+
+        // Data is cut short once the budget runs out
+        uint32_t left = budget - (reply.size + staged + head);
+        record.bytes = ((fentry.size < left) ? (fentry.size) : (left));
+
+        memcpy(&stage[staged], &record, sizeof(mget_record_t));
+        staged += sizeof(mget_record_t);
+        memcpy(&stage[staged], &fentry, offsetof(fentry_t, name));
+        staged += offsetof(fentry_t, name);
+        memcpy(&stage[staged], path, len + 1);
+        staged += len + 1;
+
+        if(file == NULL)
+        {
+            reply.count++;
+            continue;
+        }
+
+        // Small files are packed with the records, larger ones are copied extent by extent
+        if((staged + record.bytes) <= stageSize)
+        {
+            ExtentsRead(&file->extents, 0, &stage[staged], record.bytes);
+            staged += record.bytes;
+        }
+        else
+        {
+            MsgWrite(rcvid, stage, staged, sizeof(mget_reply_t) + reply.size);
+            reply.size += staged;
+            staged = 0;
+
+            uint32_t pos = 0;
+            while(pos < record.bytes)
+            {
+                size_t avail;
+                char* src = (char*)ExtentsMap(&file->extents, pos, &avail);
+                size_t size = (((record.bytes - pos) < avail) ? (record.bytes - pos) : (avail));
+
+                MsgWrite(rcvid, src, size, sizeof(mget_reply_t) + reply.size);
+                reply.size += size;
+                pos += size;
+            }
+        }
+
+        RwLockUnlock(&file->lock);
+
+        reply.count++;
+    }
+
+    if(staged > 0)
+    {
+        MsgWrite(rcvid, stage, staged, sizeof(mget_reply_t) + reply.size);
+        reply.size += staged;
+    }
+
+    return MsgRespond(rcvid, E_OK, (const char*)&reply, sizeof(mget_reply_t));
+}
+
+int32_t ProcInfoUnlink(int32_t rcvid, io_hdr_t* hdr, char* buffer, uint32_t offset)
+{
+    if((offset == 0) || (offset >= SERVER_BUFFER_SIZE))
+    {
+        return MsgRespond(rcvid, E_INVAL, NULL, 0);
+    }
+
+    // In case sender did not put a terminator character
+    buffer[offset] = 0;
+
+    ProcTreeWrite();
+
+    file_t* file = ProcFileGet(NULL, buffer);
+    int32_t ret = E_NO_RES;
+
+    // Read only files are generated by the server and stay
+    if(file != NULL)
+    {
+        ret = ((file->access != O_RDONLY) ? (ProcFileDelete(file)) : (E_INVAL));
+    }
+
+    ProcTreeUnlock();
+
+    return MsgRespond(rcvid, ret, NULL, 0);
+}
+
+int32_t ProcInfoRename(int32_t rcvid, io_hdr_t* hdr, char* buffer, uint32_t offset)
+{
+    if((offset == 0) || (offset >= SERVER_BUFFER_SIZE))
+    {
+        return MsgRespond(rcvid, E_INVAL, NULL, 0);
+    }
+
+    // In case sender did not put a terminator character
+    buffer[offset] = 0;
+
+    // New path follows the old one
+    uint32_t len = strlen(buffer);
+
+    if((len + 1) >= offset)
+    {
+        return MsgRespond(rcvid, E_INVAL, NULL, 0);
+    }
+
+    const char* path = &buffer[len + 1];
+
+    ProcTreeWrite();
+
+    file_t* file = ProcFileGet(NULL, buffer);
+    file_t* target = ProcFileGet(NULL, path);
+    int32_t ret = E_NO_RES;
+
+    // Read only files are generated by the server and are never replaced
+    if((target != NULL) && (target->access == O_RDONLY))
+    {
+        ret = E_INVAL;
+    }
+    else if(file != NULL)
+    {
+        // Clones may be taken of any file, renames only move writable ones
+        if(hdr->code == INFO_CLONE)
+        {
+            ret = ProcFileClone(file, path);
+        }
+        else
+        {
+            ret = ((file->access != O_RDONLY) ? (ProcFileRename(file, path)) : (E_INVAL));
+        }
+    }
+
+    ProcTreeUnlock();
+
+    return MsgRespond(rcvid, ret, NULL, 0);
+}
+
+int32_t ProcFilePrivate(file_t* file)
+{
+    // Clients mapping the borrowed pages would keep reading them once the file moves to its copy
+    if((file->maps != 0) && ExtentsBorrowed(&file->extents))
+    {
+        return E_BUSY;
+    }
+
+    return ExtentsPrivate(&file->extents);
+}
+
+int32_t ProcFileExtend(file_t* file, uint32_t pos, size_t size)
+{
+    // Client positions are not trusted, the end of the write has to fit in a file size
+    if(pos > (FILE_SIZE_MAX - size))
+    {
+        return E_INVAL;
+    }
+
+    // Contents change, the file is compared again once closed
+    file->dirty = 1;
+
+    // Files served from the boot image get a private copy on the first write
+    if(ProcFilePrivate(file) != E_OK)
+    {
+        return E_ERROR;
+    }
+
+    // Writing past the end of file extends it
+    if((pos + size) > file->size)
+    {
+        if(ExtentsGrow(&file->extents, pos + size) != E_OK)
+        {
+            return E_NO_RES;
+        }
+
+        // Fill the gap left by a seek past the end of file
+        if(pos > file->size)
+        {
+            ExtentsZero(&file->extents, file->size, pos - file->size);
+        }
+
+        file->size = pos + size;
+    }
+
+    return E_OK;
+}
+
+size_t ProcFileReceive(int32_t rcvid, file_t* file, uint32_t pos, uint32_t msgOffset, size_t size)
+{
+    size_t done = 0;
+
+    // Each chunk is bounded by the extent holding it so client data never lands outside the file
+    while(done < size)
+    {
+        size_t avail;
+        char* dst = (char*)ExtentsMap(&file->extents, pos + done, &avail);
+
+        if(dst == NULL)
+        {
+            break;
+        }
+
+        size_t chunk = (((size - done) < avail) ? (size - done) : (avail));
+        int32_t got = MsgRead(rcvid, dst, chunk, msgOffset + done);
+
+        if(got <= 0)
+        {
+            break;
+        }
+
+        done += got;
+    }
+
+    return done;
+}
+
+// Writes buffered bytes then receives the rest, capacity grows one step ahead of the data so unsent bytes allocate nothing
+size_t ProcFileWriteData(int32_t rcvid, file_t* file, uint32_t pos, const char* buffer, size_t buffered, uint32_t msgOffset, size_t size)
+{
+    size_t done = 0;
+
+    while(done < size)
+    {
+        size_t chunk = size - done;
+
+        if(done < buffered)
+        {
+            chunk = (((buffered - done) < chunk) ? (buffered - done) : (chunk));
+        }
+        else
+        {
+            chunk = ((chunk < FILE_WRITE_STEP) ? (chunk) : (FILE_WRITE_STEP));
+        }
+
+        // Out of memory, write what fits in the capacity already held
+        if(ExtentsGrow(&file->extents, pos + done + chunk) != E_OK)
+        {
+            if((pos + done) >= file->extents.capacity)
+            {
+                break;
+            }
+
+            chunk = file->extents.capacity - (pos + done);
+            size = done + chunk;
+        }
+
+        size_t got = ((done < buffered) ? (ExtentsWrite(&file->extents, pos + done, &buffer[done], chunk)) :
+                                          (ProcFileReceive(rcvid, file, pos + done, msgOffset + done, chunk)));
+        done += got;
+
+        // Client went away midway
+        if(got < chunk)
+        {
+            break;
+        }
+    }
+
+    if(done == 0)
+    {
+        return 0;
+    }
+
+    // Contents change, the file is compared again once closed
+    file->dirty = 1;
+
+    if((pos + done) > file->size)
+    {
+        // Fill the gap left by a seek past the end of file
+        if(pos > file->size)
+        {
+            ExtentsZero(&file->extents, file->size, pos - file->size);
+        }
+
+        file->size = pos + done;
+    }
+
+    return done;
+}
+
+int32_t ProcFileReadVector(int32_t rcvid, file_t* file, io_hdr_t* hdr, char* buffer, uint32_t offset)
+{
+    uint32_t count = offset / sizeof(io_segment_t);
+    io_segment_t* segments = (io_segment_t*)buffer;
+
+    if(count == 0)
+    {
+        return MsgRespond(rcvid, -1, NULL, 0);
+    }
+
+    RwLockRead(&file->lock);
+
+    uint32_t total = 0;
+    uint32_t i;
+    for(i = 0; i < count; i++)
+    {
+        uint32_t pos = segments[i].offset;
+
+        if(pos >= file->size)
+        {
+            break;
+        }
+
+        // Segments are clipped to the end of file and to the reply size
+        uint32_t size = segments[i].size;
+        size = ((size < (file->size - pos)) ? (size) : (file->size - pos));
+        size = ((size < (hdr->rbytes - total)) ? (size) : (hdr->rbytes - total));
+
+        // Segment data is written straight from the extents into the client reply
+        uint32_t done = 0;
+        while(done < size)
+        {
+            size_t avail;
+            char* src = (char*)ExtentsMap(&file->extents, pos + done, &avail);
+            size_t chunk = (((size - done) < avail) ? (size - done) : (avail));
+
+            MsgWrite(rcvid, src, chunk, total + done);
+            done += chunk;
+        }
+
+        total += size;
+
+        // A short segment ends the request so the data stays back to back
+        if(size < segments[i].size)
+        {
+            break;
+        }
+    }
+
+    RwLockUnlock(&file->lock);
+
+    return MsgRespond(rcvid, total, NULL, 0);
+}
+
+int32_t ProcFileWriteVector(int32_t rcvid, file_t* file, io_hdr_t* hdr, char* buffer, uint32_t offset)
+{
+    // Only the bytes received in the dispatcher buffer are written
+    size_t received = ((hdr->sbytes < offset) ? (hdr->sbytes) : (offset));
+
+    if(received < sizeof(uint32_t))
+    {
+        return MsgRespond(rcvid, -1, NULL, 0);
+    }
+
+    uint32_t count = *((uint32_t*)buffer);
+    io_segment_t* segments = (io_segment_t*)&buffer[sizeof(uint32_t)];
+    size_t header = sizeof(uint32_t) + (count * sizeof(io_segment_t));
+
+    if((count == 0) || (count > (received / sizeof(io_segment_t))) || (header > received))
+    {
+        return MsgRespond(rcvid, -1, NULL, 0);
+    }
+
+    const char* src = &buffer[header];
+    size_t avail = received - header;
+
+    // Writers are excluded per file
+    RwLockWrite(&file->lock);
+
+    uint32_t total = 0;
+    uint32_t i;
+    for(i = 0; i < count; i++)
+    {
+        // Segments whose data was not received are left out
+        if(segments[i].size > (avail - total))
+        {
+            break;
+        }
+
+        if(ProcFileExtend(file, segments[i].offset, segments[i].size) != E_OK)
+        {
+            break;
+        }
+
+        ExtentsWrite(&file->extents, segments[i].offset, &src[total], segments[i].size);
+        total += segments[i].size;
+    }
+
+    RwLockUnlock(&file->lock);
+
+    return MsgRespond(rcvid, total, NULL, 0);
+}
+
+int32_t ProcFileOpenHandle(connect_t* con, uint16_t code, const char* path, uint32_t size)
+{
+    file_t *file = NULL;
+
+    ProcTreeRead();
+
+    // Opening by handle skips path resolution, a stale handle fails
+    if(code & O_BY_HANDLE)
+    {
+        file_handle_t handle;
+
+        if(size >= sizeof(file_handle_t))
+        {
+            memcpy(&handle, path, sizeof(file_handle_t));
+            file = ProcFileGetHandle(handle.ino, handle.gen);
+        }
+
+        if(file == NULL)
+        {
+            ProcTreeUnlock();
+            return E_NO_RES;
+        }
+    }
+    else
+    {
+        file = ProcFileGet(NULL, path);
+    }
+
+    if(file == NULL)
+    {
+        ProcTreeUnlock();
+
+        if(!(code & O_CREAT))
+        {
+            return E_NO_RES;
+        }
+
+        // Creating a file changes the tree, ProcFileCreate returns the file if someone else created it meanwhile
+        ProcTreeWrite();
+
+        file = ProcFileCreate(NULL, path, NULL, 0, EXTENT_ANON, O_RDWR, FILE_MAP_PERMISSION);
+
+        if(file == NULL)
+        {
+            ProcTreeUnlock();
+            return E_ERROR;
+        }
+    }
+
+    // Only an empty plain file can become a FIFO or a circular log
+    if(((code & O_FIFO) && (file->fifo == NULL)) || ((code & O_LOG) && (file->log == NULL)))
+    {
+        RwLockWrite(&file->lock);
+
+        if((code & O_CREAT) && (file->fifo == NULL) && (file->log == NULL) && (file->size == 0) && (file->generate == NULL) && (file->maps == 0))
+        {
+            if(code & O_FIFO)
+            {
+                file->fifo = FifoCreate();
+            }
+            else
+            {
+                file->log = LogRingCreate();
+            }
+        }
+
+        RwLockUnlock(&file->lock);
+
+        if((file->fifo == NULL) && (file->log == NULL))
+        {
+            ProcTreeUnlock();
+            return E_INVAL;
+        }
+    }
+
+    // Tree lock is held until the file is referenced so it cannot be deleted
+    int32_t ret = ProcFileOpen(file, code & FILE_ACCESS_MASK);
+
+    ProcTreeUnlock();
+
+    if(ret != E_OK)
+    {
+        return E_INVAL;
+    }
+
+    ConnectionSetState(con, CONNECTION_OPEN);
+    ConnectionSetAccess(con, code & 0x3);
+    ConnectionSetHandler(con, file);
+    con->flags = ((code & O_APPEND) ? (CONNECTION_APPEND) : (0));
+    con->seek = 0;
+
+    return E_OK;
+}
+
+void ProcConnectionUnmap(connect_t* con)
+{
+    // If connection was shared (mapped) we have to unshare it
+    if(con->state == CONNECTION_MAP)
+    {
+        UnshareObject(con->scoid);
+
+        // A mapped ring is not a mapping of the file data
+        if(con->ring == NULL)
+        {
+            file_t* file = (file_t*)con->handler;
+            RwLockWrite(&file->lock);
+            if(file->maps) file->maps--;
+            RwLockUnlock(&file->lock);
+        }
+    }
+
+    RingDelete((ring_t*)con->ring);
+    con->ring = NULL;
+}
+
+// Closes the file of a handle, the handle is reused by the next open
+void ProcConnectionClose(connect_t* con)
+{
+    // If connection was already closed do nothing
+    if(con->state == CONNECTION_CLOSE)
+    {
+        return;
+    }
+
+    ProcConnectionUnmap(con);
+
+    // This check shouldn't be required!
+    if(con->handler != NULL)
+    {
+        ProcFileClose((file_t*)con->handler);
+    }
+
+    ConnectionSetState(con, CONNECTION_CLOSE);
+    ConnectionSetAccess(con, O_RDONLY);
+    ConnectionSetHandler(con, NULL);
+    con->flags = 0;
+    con->seek = 0;
+}
+
+// Caller holds the root lock and the lock of its own handle, the others are locked while read
+uint32_t ProcConnectionMapped(connect_t* root, connect_t* self)
+{
+    uint32_t i;
+    for(i = 0; i < CONNECTION_HANDLES; i++)
+    {
+        connect_t* con = ConnectionHandle(root, i);
+
+        if((con == NULL) || (con == self))
+        {
+            continue;
+        }
+
+        if(con != root)
+        {
+            MutexLock(&con->lock);
+        }
+
+        uint32_t mapped = (con->state == CONNECTION_MAP);
+
+        if(con != root)
+        {
+            MutexUnlock(&con->lock);
+        }
+
+        if(mapped)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int32_t ProcRingOp(void* arg, ring_sqe_t* sqe, char* data)
+{
+    connect_t* con = (connect_t*)arg;
+    file_t* file = (file_t*)con->handler;
+    int32_t result = -1;
+
+    switch(sqe->op)
+    {
+    case RING_OP_READ:
+        // Generated files are rendered again when read from the start, like plain reads
+        if((file->generate != NULL) && (sqe->offset == 0))
+        {
+            ProcFileGenerate(file);
+        }
+
+        RwLockRead(&file->lock);
+        if(sqe->offset < file->size)
+        {
+            size_t size = ((sqe->size < (file->size - sqe->offset)) ? (sqe->size) : (file->size - sqe->offset));
+            result = ExtentsRead(&file->extents, sqe->offset, data, size);
+        }
+        else
+        {
+            result = 0;
+        }
+        RwLockUnlock(&file->lock);
+        break;
+    case RING_OP_WRITE:
+        // Generated contents are rendered by the server, FIFO and log data never lands in extents
+        if((con->access == O_RDONLY) || (file->generate != NULL) || (file->fifo != NULL) || (file->log != NULL))
+        {
+            break;
+        }
+        RwLockWrite(&file->lock);
+        if(ProcFileExtend(file, sqe->offset, sqe->size) == E_OK)
+        {
+            result = ExtentsWrite(&file->extents, sqe->offset, data, sqe->size);
+        }
+        RwLockUnlock(&file->lock);
+        break;
+    case RING_OP_SEEK:
+        if(sqe->size == SEEK_SET)
+        {
+            con->seek = (off_t)sqe->offset;
+        }
+        else if(sqe->size == SEEK_CUR)
+        {
+            con->seek += (off_t)sqe->offset;
+        }
+        else if(sqe->size == SEEK_END)
+        {
+            RwLockRead(&file->lock);
+            con->seek = (off_t)file->size + (off_t)sqe->offset;
+            RwLockUnlock(&file->lock);
+        }
+        else
+        {
+            break;
+        }
+        result = con->seek;
+        break;
+    case RING_OP_STAT:
+        RwLockRead(&file->lock);
+        result = file->size;
+        RwLockUnlock(&file->lock);
+        break;
+    default:
+        break;
+    }
+
+    return result;
+}
+
+int32_t ProcRingSetup(int32_t rcvid, connect_t* con, io_hdr_t* hdr, char* buffer, uint32_t offset)
+{
+    ring_setup_t setup;
+    file_t* file = (file_t*)con->handler;
+
+    // Whole request has to be declared and received
+    if((hdr->sbytes < sizeof(ring_setup_t)) || (offset < sizeof(ring_setup_t)))
+    {
+        return MsgRespond(rcvid, E_INVAL, NULL, 0);
+    }
+
+    // Ring can only be set up once and before the file is mapped, FIFO and log data is only streamed
+    if((con->ring != NULL) || (con->state == CONNECTION_MAP) || (file->fifo != NULL) || (file->log != NULL))
+    {
+        return MsgRespond(rcvid, E_INVAL, NULL, 0);
+    }
+
+    memcpy(&setup, buffer, sizeof(ring_setup_t));
+
+    // Geometry comes from the client, a bad one is refused rather than reported as out of memory
+    if((setup.entries == 0) || (setup.entries > RING_MAX_ENTRIES) || (setup.entries & (setup.entries - 1)) || (setup.dataSize > RING_MAX_DATA))
+    {
+        return MsgRespond(rcvid, E_INVAL, NULL, 0);
+    }
+
+    con->ring = RingCreate(setup.entries, setup.dataSize);
+
+    return MsgRespond(rcvid, ((con->ring != NULL) ? (E_OK) : (E_NO_RES)), NULL, 0);
+}
+
+/* Private functions -------------------------------------- */
+
+int32_t _io_ProcInfo(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uint32_t offset)
+{
+    // Info requests are not accounted to a connection
+    ProcRequest(rcvid, scoid, NULL, hdr, STATS_INFO);
+
+    if(TRACE_INFO(hdr->code))
+    {
+        const char* data;
+        uint32_t size = hdr->rbytes;
+        int32_t ret = TraceControl(hdr->code, &data, &size);
+        return MsgRespond(rcvid, ret, data, size);
+    }
+
+    if(hdr->code == INFO_DCACHE_STATS)
+    {
+        dcache_stats_t stats;
+        DcacheStats(&stats);
+        return MsgRespond(rcvid, E_OK, (const char*)&stats, sizeof(stats));
+    }
+
+    if(hdr->code == INFO_LIST_PAGE)
+    {
+        return ProcInfoListPage(rcvid, hdr, buffer, offset);
+    }
+
+    if(hdr->code == INFO_MULTI_GET)
+    {
+        return ProcInfoMultiGet(rcvid, hdr, buffer, offset);
+    }
+
+    if(hdr->code == INFO_UNLINK)
+    {
+        return ProcInfoUnlink(rcvid, hdr, buffer, offset);
+    }
+
+    if((hdr->code == INFO_RENAME) || (hdr->code == INFO_CLONE))
+    {
+        return ProcInfoRename(rcvid, hdr, buffer, offset);
+    }
+
+    if(hdr->code == INFO_CHECKPOINT)
+    {
+        // Tree stays unchanged while the image is written
+        ProcTreeWrite();
+        int32_t ret = CheckpointSave(ProcDirGet(NULL, CHECKPOINT_PATH));
+        ProcTreeUnlock();
+
+        return MsgRespond(rcvid, ret, NULL, 0);
+    }
+
+    if((hdr->code != INFO_LIST_ALL) || (offset == 0) || (offset >= SERVER_BUFFER_SIZE))
+    {
+        return MsgRespond(rcvid, E_INVAL, NULL, 0);
+    }
+
+    // In case sender did not put a terminator character
+    buffer[offset] = 0;
+
+    ProcFileGenerateAll();
+
+    ProcTreeRead();
+
+    dir_t* cwd = ProcDirGet(NULL, buffer);
+
+    // Are we listing a file or is the path invalid?
+    if(cwd == NULL)
+    {
+        ProcTreeUnlock();
+        return MsgRespond(rcvid, E_INVAL, NULL, 0);
+    }
+
+    // Listing is cut at what fits the reply, larger directories are listed with INFO_LIST_PAGE
+    uint32_t limit = ((hdr->rbytes < SERVER_BUFFER_SIZE) ? (hdr->rbytes) : (SERVER_BUFFER_SIZE));
+    uint32_t size = CopyEntries(buffer, cwd, limit);
+
+    ProcTreeUnlock();
+
+    return MsgRespond(rcvid, E_OK, buffer, size);
+}
+
+int32_t ProcOpen(int32_t rcvid, int32_t scoid, connect_t* root, io_hdr_t *hdr, char *buffer, uint32_t offset)
+{
+    // Path or file handle has to fit the dispatcher buffer with its terminator
+    if((root == NULL) || (offset == 0) || (offset >= SERVER_BUFFER_SIZE))
+    {
+        return MsgRespond(rcvid, E_INVAL, NULL, 0);
+    }
+
+    // Handle allocation is serialized by the connection lock
+    MutexLock(&root->lock);
+
+    // Handle 0 is used while it is closed, further opens get their own handle
+    connect_t* con = ConnectionHandleAlloc(root);
+
+    if(con == NULL)
+    {
+        MutexUnlock(&root->lock);
+        return MsgRespond(rcvid, E_BUSY, NULL, 0);
+    }
+
+    if(con != root)
+    {
+        MutexLock(&con->lock);
+    }
+
+    // In case sender did not put a terminator character
+    buffer[offset] = 0;
+
+    int32_t ret = ProcFileOpenHandle(con, hdr->code, (const char*)buffer, offset);
+
+    // Clients tag later messages with the handle, the file handle lets them reopen the file without a path
+    open_reply_t reply;
+    reply.handle = con->handle;
+
+    if(ret == E_OK)
+    {
+        reply.file.ino = ((file_t*)con->handler)->ino;
+        reply.file.gen = ((file_t*)con->handler)->gen;
+    }
+
+    if(con != root)
+    {
+        MutexUnlock(&con->lock);
+    }
+
+    MutexUnlock(&root->lock);
+
+    // Old clients do not ask for a reply and use handle 0
+    if((ret != E_OK) || (hdr->rbytes < sizeof(uint32_t)))
+    {
+        return MsgRespond(rcvid, ret, NULL, 0);
     }
 
-    return size;
+    return MsgRespond(rcvid, E_OK, (const char*)&reply, ((hdr->rbytes < sizeof(open_reply_t)) ? (sizeof(uint32_t)) : (sizeof(open_reply_t))));
 }
 
-uint32_t CopyFileEntries(char* buffer, dir_t* cwd)
+int32_t _io_FileOpen(int32_t rcvid, int32_t scoid, io_hdr_t *hdr, char *buffer, uint32_t offset)
 {
-    uint32_t size = 0;
-    file_t* file = cwd->files;
-    for( ; file != NULL; file = file->sibling)
-    {
-        fentry_t fentry = {INFO_FILE, file->size, (uint16_t)file->len};
-        
-        memcpy(&buffer[size], &fentry, offsetof(fentry_t, name));
-        size += offsetof(fentry_t, name);
-        memcpy(&buffer[size], file->name, file->len);
-        size += file->len + 1;
-        buffer[size - 1] = 0;
-    }
+    // Connection stays allocated until the request is done with it
+    connect_t* root = ConnectionGet(scoid);
 
-    return size;
+    ProcRequest(rcvid, scoid, root, hdr, STATS_OPEN);
+    int32_t ret = ProcOpen(rcvid, scoid, root, hdr, buffer, offset);
+    ConnectionPut(root);
+
+    return ret;
 }
 
+int32_t ProcClose(int32_t rcvid, int32_t scoid, connect_t* root, io_hdr_t *hdr, char *buffer, uint32_t offset)
+{
+    // Not used
+    (void)buffer;
 
-/* Private functions -------------------------------------- */
+    connect_t* con = ConnectionHandle(root, IO_HANDLE(hdr->code));
 
-int32_t _io_ProcInfo(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uint32_t offset)
-{
-    if(hdr->code != INFO_LIST_ALL)
+    if(con == NULL)
     {
         return MsgRespond(rcvid, E_INVAL, NULL, 0);
     }
 
-    char* remaining = NULL;
-    dir_t* cwd = ProcPathResolve(NULL, buffer, &remaining);
+    // Closed handle is released for reuse, the connection itself stays attached
+    MutexLock(&con->lock);
+    ProcConnectionClose(con);
+    MutexUnlock(&con->lock);
 
-    // Are we listing a file or is the path invalid?
-    if(remaining != NULL)
-    {
-        return MsgRespond(rcvid, E_INVAL, NULL, 0);
-        return E_OK;
-    }
+    return MsgRespond(rcvid, E_OK, NULL, 0);
+}
 
-    uint32_t size = CopyDirEntries(buffer, cwd);
-    size += CopyFileEntries(&buffer[size], cwd);
+int32_t _io_FileClose(int32_t rcvid, int32_t scoid, io_hdr_t *hdr, char *buffer, uint32_t offset)
+{
+    // Connection stays allocated until the request is done with it
+    connect_t* root = ConnectionGet(scoid);
 
-    return MsgRespond(rcvid, E_OK, buffer, size);
+    ProcRequest(rcvid, scoid, root, hdr, STATS_CLOSE);
+    int32_t ret = ProcClose(rcvid, scoid, root, hdr, buffer, offset);
+    ConnectionPut(root);
+
+    return ret;
 }
 
-int32_t _io_FileOpen(int32_t rcvid, int32_t scoid, io_hdr_t *hdr, char *buffer, uint32_t offset)
+int32_t ProcRead(int32_t rcvid, int32_t scoid, connect_t* root, io_hdr_t *hdr, char *buffer, uint32_t offset)
 {
-    connect_t* con = ConnectionGet(scoid);
+    connect_t* con = ConnectionHandle(root, IO_HANDLE(hdr->code));
+    uint16_t code = IO_CODE(hdr->code);
 
-    // Only open connection if it is closed
-    if((con->handler != NULL) || (con->state != CONNECTION_CLOSE))
+    if(con == NULL)
     {
-        return MsgRespond(rcvid, E_BUSY, NULL, 0);
+        return MsgRespond(rcvid, -1, NULL, 0);
     }
 
-    // In case sender did not put a terminator character
-    buffer[hdr->sbytes] = 0;
+    MutexLock(&con->lock);
+
+    // Only read id connection is not closed
+    if((con->handler == NULL) || (con->state == CONNECTION_CLOSE))
+    {
+        MutexUnlock(&con->lock);
+        return MsgRespond(rcvid, -1, NULL, 0);
+    }
 
-    file_t *file = ProcFileGet(NULL, (const char*)buffer);
+    file_t* file = (file_t*)con->handler;
 
-    if(file == NULL)
+    // FIFO reads wait for data, the reply is sent by whoever completes them
+    if(file->fifo != NULL)
     {
-        if(!(hdr->code & O_CREAT))
+        MutexUnlock(&con->lock);
+
+        int32_t ret = ((code == 0) ? (FifoRead(file->fifo, rcvid, hdr->rbytes)) : (E_INVAL));
+
+        if(ret == FIFO_DEFERRED)
         {
-            return MsgRespond(rcvid, E_NO_RES, NULL, 0);
+            ProcDefer(rcvid);
+            return E_OK;
         }
 
-        //void* data = mmap(NULL, FILE_DEFAULT_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANON, NOFD, 0x0);
-        //file = ProcFileCreate(NULL, (const char*)buffer, data, FILE_DEFAULT_SIZE, O_RDWR, FILE_MAP_PERMISSION);
-        file = ProcFileCreate(NULL, (const char*)buffer, NULL, 0, O_RDWR, FILE_MAP_PERMISSION);
-
-        if(file == NULL)
+#ifdef PROC_STATS
+        // Data was already written to the reply
+        if(ret > 0)
         {
-            return MsgRespond(rcvid, E_ERROR, NULL, 0);
+            StatsWritten(rcvid, ret);
         }
+#endif
+
+        return MsgRespond(rcvid, ret, NULL, 0);
     }
 
-    if(ProcFileOpen(file, hdr->code & FILE_ACCESS_MASK) != E_OK)
+    // Log reads return the records from a sequence on, positional ones with their sequence numbers
+    if(file->log != NULL)
     {
-        return MsgRespond(rcvid, E_INVAL, NULL, 0);
-    }
+        if(((code != 0) && (code != IO_READ_AT)) || ((code == IO_READ_AT) && (offset < sizeof(off_t))))
+        {
+            MutexUnlock(&con->lock);
+            return MsgRespond(rcvid, E_INVAL, NULL, 0);
+        }
 
-    ConnectionSetState(con, CONNECTION_OPEN);
-    ConnectionSetAccess(con, hdr->code & 0x3);
-    ConnectionSetHandler(con, file);
-    con->seek = 0;
+        uint32_t seq = ((code == IO_READ_AT) ? ((uint32_t)*((off_t*)buffer)) : ((uint32_t)con->seek));
 
-    return MsgRespond(rcvid, E_OK, NULL, 0);
-}
+        // Records are staged in the dispatcher buffer, other connections keep appending meanwhile
+        uint32_t size = LogRingRead(file->log, &seq, buffer, ((hdr->rbytes < SERVER_BUFFER_SIZE) ? (hdr->rbytes) : (SERVER_BUFFER_SIZE)), (code == IO_READ_AT));
 
-int32_t _io_FileClose(int32_t rcvid, int32_t scoid, io_hdr_t *hdr, char *buffer, uint32_t offset)
-{
-    // Not used
-    (void)hdr; (void)buffer;
+        if(code != IO_READ_AT)
+        {
+            con->seek = seq;
+        }
 
-#ifdef HANDLE_CLOSE_IO  
-    connect_t* con = ConnectionGet(scoid);
+        MutexUnlock(&con->lock);
 
-    // If connection was already closed do nothing
-    if(con->state == CONNECTION_CLOSE)
-    {
-        return MsgRespond(rcvid, E_OK, NULL, 0);
+        return MsgRespond(rcvid, size, buffer, size);
     }
 
-    // If connection was shared (mapped) we have to unshare it
-    if(con->state == CONNECTION_MAP)
+    if(code == IO_READ_VECTOR)
     {
-        UnshareObject(scoid);
+        MutexUnlock(&con->lock);
+        return ProcFileReadVector(rcvid, file, hdr, buffer, offset);
     }
 
-    // This check shouldn't be required!
-    if(con->handler != NULL)
+    // Ring requests run under the connection lock, a ring serves one connection
+    if(code == IO_READ_RING_SETUP)
     {
-        ProcFileClose((file_t*)con->handler);
+        int32_t ret = ProcRingSetup(rcvid, con, hdr, buffer, offset);
+        MutexUnlock(&con->lock);
+        return ret;
     }
 
-    ConnectionSetState(con, CONNECTION_CLOSE);
-    ConnectionSetAccess(con, O_RDONLY);
-    ConnectionSetHandler(con, NULL);
-    con->seek = 0;
-#endif
+    if(code == IO_READ_RING_ENTER)
+    {
+        // Ring has to be mapped by the client
+        uint32_t done = ((con->state == CONNECTION_MAP) && (con->ring != NULL)) ? (RingDrain((ring_t*)con->ring, ProcRingOp, con)) : (0);
+        MutexUnlock(&con->lock);
+        return MsgRespond(rcvid, done, NULL, 0);
+    }
 
-    return MsgRespond(rcvid, E_OK, NULL, 0);
-}
+    // Positional reads carry their own position
+    if((code == IO_READ_AT) && (offset < sizeof(off_t)))
+    {
+        MutexUnlock(&con->lock);
+        return MsgRespond(rcvid, -1, NULL, 0);
+    }
 
-int32_t _io_FileRead(int32_t rcvid, int32_t scoid, io_hdr_t *hdr, char *buffer, uint32_t offset)
-{
-    connect_t* con = ConnectionGet(scoid);
+    uint32_t readPos = ((code == IO_READ_AT) ? ((uint32_t)*((off_t*)buffer)) : ((uint32_t)con->seek));
 
-    // Only read id connection is not closed
-    if((con->handler == NULL) || (con->state == CONNECTION_CLOSE))
+    // Generated files are rendered again every time they are read from the start
+    if((file->generate != NULL) && (readPos == 0))
     {
-        return MsgRespond(rcvid, -1, NULL, 0);
+        ProcFileGenerate(file);
     }
 
-    file_t* file = (file_t*)con->handler;
+    // Readers of the same file run in parallel
+    RwLockRead(&file->lock);
 
-    if(con->seek >= file->size)
+    if(readPos >= file->size)
     {
+        RwLockUnlock(&file->lock);
+        MutexUnlock(&con->lock);
         return MsgRespond(rcvid, 0, NULL, 0);
     }
 
-    uint32_t readPos = con->seek;
-
     // Compute read size
     size_t size = (((hdr->rbytes + readPos) < (file->size)) ? (hdr->rbytes) : (file->size - readPos));
 
-    con->seek += size;
+    // Reads are served straight from the extent holding readPos so they stop at its end
+    size_t avail;
+    char* src = (char*)ExtentsMap(&file->extents, readPos, &avail);
+
+    if(size > avail)
+    {
+        size = avail;
+    }
+
+    if(code != IO_READ_AT)
+    {
+        con->seek += size;
+    }
+
+    MutexUnlock(&con->lock);
+
+    // File data has to stay valid until it is copied to the client
+    int32_t ret = MsgRespond(rcvid, size, src, size);
 
-    char* src = (char*)file->data;
+    RwLockUnlock(&file->lock);
 
-    return MsgRespond(rcvid, size, &src[readPos], size);
+    return ret;
 }
 
-int32_t _io_FileWrite(int32_t rcvid, int32_t scoid, io_hdr_t *hdr, char *buffer, uint32_t offset)
+int32_t _io_FileRead(int32_t rcvid, int32_t scoid, io_hdr_t *hdr, char *buffer, uint32_t offset)
+{
+    // Connection stays allocated until the request is done with it
+    connect_t* root = ConnectionGet(scoid);
+
+    ProcRequest(rcvid, scoid, root, hdr, STATS_READ);
+    int32_t ret = ProcRead(rcvid, scoid, root, hdr, buffer, offset);
+    ConnectionPut(root);
+
+    return ret;
+}
+
+int32_t ProcWrite(int32_t rcvid, int32_t scoid, connect_t* root, io_hdr_t *hdr, char *buffer, uint32_t offset)
 {
-    connect_t* con = ConnectionGet(scoid);
+    connect_t* con = ConnectionHandle(root, IO_HANDLE(hdr->code));
+    uint16_t code = IO_CODE(hdr->code);
+
+    if(con == NULL)
+    {
+        return MsgRespond(rcvid, -1, NULL, 0);
+    }
+
+    MutexLock(&con->lock);
 
     // Only write id connection is not closed and file is open we write enabled
     if(((con->handler == NULL) || (con->state == CONNECTION_CLOSE)) || (con->access == O_RDONLY))
     {
+        MutexUnlock(&con->lock);
         return MsgRespond(rcvid, -1, NULL, 0);
     }
 
     file_t* file = (file_t*)con->handler;
 
-    if(con->seek >= file->size)
+    // Data beyond the dispatcher buffer is pulled from the client later
+    size_t received = ((hdr->sbytes < offset) ? (hdr->sbytes) : (offset));
+
+    // FIFO writes wait while the ring is full
+    if(file->fifo != NULL)
     {
-        return MsgRespond(rcvid, 0, NULL, 0);
+        MutexUnlock(&con->lock);
+
+        int32_t ret = ((code == 0) ? (FifoWrite(file->fifo, rcvid, buffer, received, hdr->sbytes)) : (E_INVAL));
+
+        if(ret == FIFO_DEFERRED)
+        {
+            ProcDefer(rcvid);
+            return E_OK;
+        }
+
+        return MsgRespond(rcvid, ret, NULL, 0);
+    }
+
+    // Log appends reserve their slots atomically, writers only hold their own connection
+    if(file->log != NULL)
+    {
+        MutexUnlock(&con->lock);
+
+        int32_t ret = ((code == 0) ? (LogRingAppend(file->log, rcvid, buffer, received, 0, hdr->sbytes)) : (E_INVAL));
+
+        return MsgRespond(rcvid, ret, NULL, 0);
+    }
+
+    if(code == IO_WRITE_VECTOR)
+    {
+        MutexUnlock(&con->lock);
+        return ProcFileWriteVector(rcvid, file, hdr, buffer, offset);
+    }
+
+    size_t start = 0;
+
+    // Positional writes carry their own position ahead of the data
+    if(code == IO_WRITE_AT)
+    {
+        if(received < sizeof(off_t))
+        {
+            MutexUnlock(&con->lock);
+            return MsgRespond(rcvid, -1, NULL, 0);
+        }
+
+        start = sizeof(off_t);
+    }
+
+    // Declared size only bounds the write, the file grows by what is actually received
+    size_t size = hdr->sbytes - start;
+
+    // Writers are excluded per file
+    RwLockWrite(&file->lock);
+
+    // Appends land at the current end of file, the file lock makes them atomic
+    uint32_t writePos;
+
+    if(code == IO_WRITE_AT)
+    {
+        writePos = (uint32_t)*((off_t*)buffer);
+    }
+    else
+    {
+        writePos = ((con->flags & CONNECTION_APPEND) ? (file->size) : (con->seek));
+    }
+
+    // Positional writes leave the connection alone, the others move its position once the data is in
+    if(code == IO_WRITE_AT)
+    {
+        MutexUnlock(&con->lock);
+    }
+
+    // End of the write has to fit in a file size, files served from the boot image get a private copy on the first write
+    if((writePos > (FILE_SIZE_MAX - size)) || (ProcFilePrivate(file) != E_OK))
+    {
+        RwLockUnlock(&file->lock);
+
+        if(code != IO_WRITE_AT)
+        {
+            MutexUnlock(&con->lock);
+        }
+
+        return MsgRespond(rcvid, -1, NULL, 0);
     }
 
-    uint32_t writePos = con->seek;
+    size_t done = ProcFileWriteData(rcvid, file, writePos, &buffer[start], received - start, start, size);
 
-    // Compute write size
-    size_t size = (((hdr->sbytes + writePos) < (file->size)) ? (hdr->sbytes) : (file->size - writePos));
+    RwLockUnlock(&file->lock);
+
+    if(code != IO_WRITE_AT)
+    {
+        con->seek = writePos + done;
+        MutexUnlock(&con->lock);
+    }
 
-    con->seek += size;
+    return MsgRespond(rcvid, done, NULL, 0);
+}
 
-    char* dst = (char*)file->data;
+int32_t _io_FileWrite(int32_t rcvid, int32_t scoid, io_hdr_t *hdr, char *buffer, uint32_t offset)
+{
+    // Connection stays allocated until the request is done with it
+    connect_t* root = ConnectionGet(scoid);
 
-    memcpy(&dst[writePos], buffer, hdr->sbytes);
+    ProcRequest(rcvid, scoid, root, hdr, STATS_WRITE);
+    int32_t ret = ProcWrite(rcvid, scoid, root, hdr, buffer, offset);
+    ConnectionPut(root);
 
-    return MsgRespond(rcvid, size, NULL, 0);
+    return ret;
 }
 
-int32_t _io_FileSeek(int32_t rcvid, int32_t scoid, io_hdr_t *hdr, char *buffer, uint32_t offset)
+int32_t ProcSeek(int32_t rcvid, int32_t scoid, connect_t* root, io_hdr_t *hdr, char *buffer, uint32_t offset)
 {
-    connect_t* con = ConnectionGet(scoid);
+    connect_t* con = ConnectionHandle(root, IO_HANDLE(hdr->code));
+    uint16_t code = IO_CODE(hdr->code);
+
+    if(con == NULL)
+    {
+        return MsgRespond(rcvid, E_ERROR, NULL, 0);
+    }
+
+    MutexLock(&con->lock);
 
     // Only seek if file is opend
     if((con->handler == NULL) || (con->state == CONNECTION_CLOSE))
     {
+        MutexUnlock(&con->lock);
         return MsgRespond(rcvid, E_ERROR, NULL, 0);
     }
 
     file_t* file = (file_t*)con->handler;
 
-    switch (hdr->code)
+    switch (code)
     {
     case SEEK_SET:
         con->seek = *((off_t*)buffer);
@@ -256,108 +1477,254 @@ int32_t _io_FileSeek(int32_t rcvid, int32_t scoid, io_hdr_t *hdr, char *buffer,
         con->seek += *((off_t*)buffer);
         break;
     case SEEK_END:
-        con->seek = (off_t)file->size + *((off_t*)buffer);
+        RwLockRead(&file->lock);
+        // The end of a log is the sequence of the next record
+        con->seek = (off_t)((file->log != NULL) ? (LogRingHead(file->log)) : (file->size)) + *((off_t*)buffer);
+        RwLockUnlock(&file->lock);
         break;
     default:
+        MutexUnlock(&con->lock);
         return MsgRespond(rcvid, E_INVAL, NULL, 0);
         break;
     }
 
-    return MsgRespond(rcvid, E_OK, (const char*)&con->seek, sizeof(off_t));
+    off_t seek = con->seek;
+
+    MutexUnlock(&con->lock);
+
+    return MsgRespond(rcvid, E_OK, (const char*)&seek, sizeof(off_t));
 }
 
-int32_t _io_FileTruncate(int32_t rcvid, int32_t scoid, io_hdr_t *hdr, char *buffer, uint32_t offset)
+int32_t _io_FileSeek(int32_t rcvid, int32_t scoid, io_hdr_t *hdr, char *buffer, uint32_t offset)
+{
+    // Connection stays allocated until the request is done with it
+    connect_t* root = ConnectionGet(scoid);
+
+    ProcRequest(rcvid, scoid, root, hdr, STATS_SEEK);
+    int32_t ret = ProcSeek(rcvid, scoid, root, hdr, buffer, offset);
+    ConnectionPut(root);
+
+    return ret;
+}
+
+int32_t ProcTruncate(int32_t rcvid, int32_t scoid, connect_t* root, io_hdr_t *hdr, char *buffer, uint32_t offset)
 {
-    connect_t* con = ConnectionGet(scoid);
+    connect_t* con = ConnectionHandle(root, IO_HANDLE(hdr->code));
+
+    if(con == NULL)
+    {
+        return MsgRespond(rcvid, E_ERROR, NULL, 0);
+    }
+
+    MutexLock(&con->lock);
 
     // Only truncate if file is opened
     if((con->handler == NULL) || (con->state == CONNECTION_CLOSE))
     {
+        MutexUnlock(&con->lock);
         return MsgRespond(rcvid, E_ERROR, NULL, 0);
     }
 
     file_t* file = (file_t*)con->handler;
 
-    // Does file allows mapping
-    if(!(file->permission & FILE_MAP_PERMISSION))
+    MutexUnlock(&con->lock);
+
+    // Does file allows mapping, FIFOs and logs have a fixed capacity
+    if(!(file->permission & FILE_MAP_PERMISSION) || (file->fifo != NULL) || (file->log != NULL))
     {
         return MsgRespond(rcvid, E_ERROR, NULL, 0);
     }
 
     off_t size = (off_t)ALIGN_UP((*(uint32_t*)buffer), 4096);
 
+    // Only the file being resized is locked
+    RwLockWrite(&file->lock);
+
+    int32_t ret = E_OK;
+
     if(file->size < (size_t)size)
     {
-        void* newData = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANON, NOFD, 0x0);
-        memcpy(newData, file->data, file->size);
-        memset(newData + file->size, 0x0, size - file->size);
-        munmap(file->data, file->size);
-        file->size = size;
-        file->data = newData;
+        // Growing appends extents, existing data is never moved
+        ret = ExtentsGrow(&file->extents, size);
+
+        if(ret == E_OK)
+        {
+            // Private copy of boot image data
+            ret = ProcFilePrivate(file);
+        }
+
+        if(ret == E_OK)
+        {
+            // Capacity may hold data from before a previous shrink
+            ExtentsZero(&file->extents, file->size, size - file->size);
+            file->size = size;
+            file->dirty = 1;
+        }
     }
     else
     {
-        void* newData = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANON, NOFD, 0x0);
-        memcpy(newData, file->data, size);
-        munmap(file->data, file->size);
+        // Shrinking releases the tail extents
+        ExtentsShrink(&file->extents, size);
         file->size = size;
-        file->data = newData;
+        file->dirty = 1;
     }
 
-    return MsgRespond(rcvid, E_OK, NULL, 0);
+    RwLockUnlock(&file->lock);
+
+    return MsgRespond(rcvid, ret, NULL, 0);
 }
 
-int32_t _io_FileShare(int32_t rcvid, int32_t scoid, io_hdr_t *hdr, char *buffer, uint32_t offset)
+int32_t _io_FileTruncate(int32_t rcvid, int32_t scoid, io_hdr_t *hdr, char *buffer, uint32_t offset)
 {
-    // Not used
-    (void)hdr; (void)buffer;
+    // Connection stays allocated until the request is done with it
+    connect_t* root = ConnectionGet(scoid);
+
+    ProcRequest(rcvid, scoid, root, hdr, STATS_TRUNCATE);
+    int32_t ret = ProcTruncate(rcvid, scoid, root, hdr, buffer, offset);
+    ConnectionPut(root);
 
-    connect_t* con = ConnectionGet(scoid);
+    return ret;
+}
 
+// Shares the handle with the client, called with the root and handle locks held
+int32_t ProcShareHandle(int32_t scoid, connect_t* root, connect_t* con)
+{
     // File is only shared once per connection
     if(con->state == CONNECTION_MAP)
     {
-        return MsgRespond(rcvid, E_OK, NULL, 0);
+        return E_OK;
+    }
+
+    // Objects are shared per scoid so only one handle of a connection can be mapped
+    if(ProcConnectionMapped(root, con))
+    {
+        return E_BUSY;
     }
 
     // Can we share the file?
     if(ConnectionSetState(con, CONNECTION_MAP) != E_OK)
     {
-        return MsgRespond(rcvid, E_INVAL, NULL, 0);
+        return E_INVAL;
+    }
+
+    // Connections with a ring map the ring instead of the file data
+    if(con->ring != NULL)
+    {
+        ring_hdr_t* ring = RingShared((ring_t*)con->ring);
+        int32_t ret = ((ShareObject(ring, scoid, 0) == ring) ? (E_OK) : (E_ERROR));
+
+        if(ret != E_OK)
+        {
+            ConnectionSetState(con, CONNECTION_OPEN);
+        }
+
+        return ret;
     }
 
     file_t* file = (file_t*)con->handler;
 
-    if(ShareObject(file->data, scoid, 0) != file->data)
+    // FIFOs map their ring, the consumer reads at dataOffset and moves the tail
+    if(file->fifo != NULL)
     {
-        return MsgRespond(rcvid, E_ERROR, NULL, 0);
+        fifo_hdr_t* ring = FifoRing(file->fifo);
+        int32_t ret = ((ShareObject(ring, scoid, 0) == ring) ? (E_OK) : (E_ERROR));
+
+        if(ret != E_OK)
+        {
+            ConnectionSetState(con, CONNECTION_OPEN);
+        }
+
+        return ret;
     }
 
-    return MsgRespond(rcvid, E_OK, NULL, 0);
+    // Sharing may replace the file data so writers are excluded
+    RwLockWrite(&file->lock);
+
+    // Clients map a single extent, data is only moved while nobody has it mapped
+    if(file->maps == 0)
+    {
+        ExtentsCoalesce(&file->extents);
+    }
+
+    extent_t* extent = file->extents.first;
+
+    // Writable mappings of boot image files need a private copy, checkpoint pages are rewritten by the next save
+    // Image pages are only shared when the file covers them whole, otherwise the client would see its neighbours
+    uint32_t copy = ((con->access != O_RDONLY) || ((extent != NULL) && (extent->flags & EXTENT_CKPT)) ||
+                     ((extent != NULL) && (extent->flags & EXTENT_RFS) && ((((uint32_t)extent->data) | extent->size) & (EXTENT_PAGE_SIZE - 1))));
+
+    if((extent == NULL) || (copy && ProcFilePrivate(file) != E_OK))
+    {
+        RwLockUnlock(&file->lock);
+        return E_ERROR;
+    }
+
+    void* shared = ShareObject(extent->data, scoid, 0);
+
+    // Fall back to a private copy if the image pages cannot be shared
+    if((shared != extent->data) && (extent->flags & EXTENT_RFS) && (ProcFilePrivate(file) == E_OK))
+    {
+        shared = ShareObject(extent->data, scoid, 0);
+    }
+
+    int32_t ret = ((shared != extent->data) ? (E_ERROR) : (E_OK));
+
+    if(ret == E_OK)
+    {
+        file->maps++;
+    }
+
+    RwLockUnlock(&file->lock);
+    return ret;
 }
 
-void _io_CloseCallBack(connect_t* con)
+int32_t ProcShare(int32_t rcvid, int32_t scoid, connect_t* root, io_hdr_t *hdr, char *buffer, uint32_t offset)
 {
-    // If connection was already closed do nothing
-    if(con->state == CONNECTION_CLOSE)
+    // Not used
+    (void)buffer;
+
+    connect_t* con = ConnectionHandle(root, IO_HANDLE(hdr->code));
+
+    if(con == NULL)
     {
-        return;
+        return MsgRespond(rcvid, E_INVAL, NULL, 0);
     }
 
-    // If connection was shared (mapped) we have to unshare it
-    if(con->state == CONNECTION_MAP)
+    // Root is locked first like on open, it keeps the other handles from being mapped meanwhile
+    if(con != root)
     {
-        UnshareObject(con->scoid);
+        MutexLock(&root->lock);
     }
 
-    // This check shouldn't be required!
-    if(con->handler != NULL)
+    MutexLock(&con->lock);
+
+    int32_t ret = ProcShareHandle(scoid, root, con);
+
+    MutexUnlock(&con->lock);
+
+    if(con != root)
     {
-        ProcFileClose((file_t*)con->handler);
+        MutexUnlock(&root->lock);
     }
 
-    ConnectionSetState(con, CONNECTION_CLOSE);
-    ConnectionSetAccess(con, O_RDONLY);
-    ConnectionSetHandler(con, NULL);
-    con->seek = 0;
+    return MsgRespond(rcvid, ret, NULL, 0);
+}
+
+int32_t _io_FileShare(int32_t rcvid, int32_t scoid, io_hdr_t *hdr, char *buffer, uint32_t offset)
+{
+    // Connection stays allocated until the request is done with it
+    connect_t* root = ConnectionGet(scoid);
+
+    ProcRequest(rcvid, scoid, root, hdr, STATS_SHARE);
+    int32_t ret = ProcShare(rcvid, scoid, root, hdr, buffer, offset);
+    ConnectionPut(root);
+
+    return ret;
+}
+
+void _io_CloseCallBack(connect_t* con)
+{
+    MutexLock(&con->lock);
+    ProcConnectionClose(con);
+    MutexUnlock(&con->lock);
 }
\ No newline at end of file
@@ -14,6 +14,7 @@
 #include <io_types.h>
 #include <fcntl.h>
 #include <connection.h>
+#include <proc_msg.h>
 
 
 /* Exported types ----------------------------------------- */
@@ -21,7 +22,7 @@
 
 
 /* Exported constants ------------------------------------- */
-
+#define SERVER_BUFFER_SIZE  2048
 
 
 /* Exported macros ---------------------------------------- */
@@ -0,0 +1,228 @@
+/**
+ * @file        proc_msg.h
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Proc File System Client Messages Definition Header File
+*/
+
+#ifndef _PROC_MSG_H_
+#define _PROC_MSG_H_
+
+/* Includes ----------------------------------------------- */
+#include <types.h>
+#include <fcntl.h>
+
+
+/* Exported types ----------------------------------------- */
+
+// Position in a directory listing, only meaningful to the proc server
+typedef struct
+{
+    uint32_t seq;
+    uint32_t hash;
+    uint32_t phase;
+}list_cursor_t;
+
+// INFO_LIST_PAGE reply header, followed by size bytes of dentry_t/fentry_t records
+typedef struct
+{
+    list_cursor_t next;
+    uint32_t      size;
+}list_page_t;
+
+// INFO_MULTI_GET reply header, followed by size bytes holding count records
+typedef struct
+{
+    uint32_t count;
+    uint32_t size;
+}mget_reply_t;
+
+// Multi-get record, followed by a fentry_t naming the requested path and bytes of file data
+typedef struct
+{
+    int32_t  status;
+    uint32_t bytes;
+}mget_record_t;
+
+// Vectored I/O segment
+typedef struct
+{
+    uint32_t offset;
+    uint32_t size;
+}io_segment_t;
+
+// Stable file handle, stays valid until the file is deleted
+typedef struct
+{
+    uint32_t ino;
+    uint32_t gen;
+}file_handle_t;
+
+// Open reply, clients asking for less only get the connection handle
+typedef struct
+{
+    uint32_t      handle;
+    file_handle_t file;
+}open_reply_t;
+
+// IO_READ_RING_SETUP request
+typedef struct
+{
+    uint32_t entries;       // Power of two, at most 1024
+    uint32_t dataSize;      // Bytes of data area for read and write buffers, at most 1 MB
+}ring_setup_t;
+
+// Submission queue entry, data is the offset of the buffer in the data area
+typedef struct
+{
+    uint32_t op;
+    uint32_t tag;
+    uint32_t offset;
+    uint32_t size;
+    uint32_t data;
+}ring_sqe_t;
+
+// Completion queue entry, result has the same meaning as the synchronous reply status
+typedef struct
+{
+    uint32_t tag;
+    int32_t  result;
+}ring_cqe_t;
+
+// Shared region header, queues and data area follow at the given offsets
+typedef struct
+{
+    volatile uint32_t sqHead;   // Advanced by the server
+    volatile uint32_t sqTail;   // Advanced by the client
+    volatile uint32_t cqHead;   // Advanced by the client
+    volatile uint32_t cqTail;   // Advanced by the server
+    uint32_t entries;
+    uint32_t sqOffset;
+    uint32_t cqOffset;
+    uint32_t dataOffset;
+    uint32_t dataSize;
+}ring_hdr_t;
+
+// FIFO ring header, a mapping reader consumes data at dataOffset and advances tail itself
+typedef struct
+{
+    volatile uint32_t head;     // Bytes written, advanced by the server
+    volatile uint32_t tail;     // Bytes read
+    uint32_t size;              // Data bytes, power of two
+    uint32_t dataOffset;
+}fifo_hdr_t;
+
+// Log IO_READ_AT reply, entries follow back to back each padded to 4 bytes
+// first is after the requested sequence if older records were overwritten, next is the sequence to ask for next
+typedef struct
+{
+    uint32_t first;
+    uint32_t next;
+}log_reply_t;
+
+typedef struct
+{
+    uint32_t seq;
+    uint32_t size;
+}log_entry_t;
+
+
+/* Exported constants ------------------------------------- */
+
+// Proc specific _IO_INFO codes
+#define INFO_DCACHE_STATS   0x100
+#define INFO_LIST_PAGE      0x101
+#define INFO_MULTI_GET      0x102
+#define INFO_UNLINK         0x103   // Path
+#define INFO_RENAME         0x104   // Old path and new path, an existing new path is replaced
+#define INFO_CLONE          0x105   // Source path and new path, data is shared copy-on-write
+#define INFO_CHECKPOINT     0x106   // Save /proc/user so the next server instance restores it
+
+// Proc specific _IO_READ and _IO_WRITE codes, positional operations leave the connection seek untouched
+#define IO_READ_AT          0x100   // off_t position
+#define IO_READ_VECTOR      0x101   // io_segment_t list, reply holds the segments back to back
+#define IO_READ_RING_SETUP  0x102   // ring_setup_t, then mmap the fd to map the ring
+#define IO_READ_RING_ENTER  0x103   // Drain the submission queue, replies the number of completions
+#define IO_WRITE_AT         0x100   // off_t position followed by the data
+#define IO_WRITE_VECTOR     0x101   // uint32_t count, io_segment_t list, then the data back to back
+
+// Ring operations
+#define RING_OP_READ        0       // Read size bytes at offset
+#define RING_OP_WRITE       1       // Write size bytes at offset
+#define RING_OP_SEEK        2       // Seek to offset, size holds whence
+#define RING_OP_STAT        3       // File size
+
+// Directory listing phases
+#define LIST_CURSOR_DIRS    0
+#define LIST_CURSOR_FILES   1
+#define LIST_CURSOR_END     2
+
+// Open flag, the request holds a file_handle_t instead of a path
+#define O_BY_HANDLE         0x0800
+
+// Open flag, with O_CREAT a missing file is created as a FIFO
+// Reads wait for data and writes wait for space, a 0 byte read waits and replies the bytes available
+#define O_FIFO              0x0400
+
+// Open flag, with O_CREAT a missing file is created as a circular log overwriting its oldest records
+// Every write appends one record, plain reads return the record data from the seek sequence on
+#define O_LOG               0x0200
+
+// Every write is done at the end of the file
+#ifndef O_APPEND
+#define O_APPEND            0x20
+
+#if (O_APPEND & (O_WRONLY | O_RDWR | O_CREAT))
+#error "O_APPEND collides with a library open flag"
+#endif
+#endif
+
+// Library open flags, proc open flags have to stay clear of them
+#ifdef O_TRUNC
+#define PROC_O_TRUNC        O_TRUNC
+#else
+#define PROC_O_TRUNC        0
+#endif
+
+#ifdef O_EXCL
+#define PROC_O_EXCL         O_EXCL
+#else
+#define PROC_O_EXCL         0
+#endif
+
+#define PROC_O_LIBRARY      (O_RDONLY | O_WRONLY | O_RDWR | O_CREAT | O_APPEND | PROC_O_TRUNC | PROC_O_EXCL)
+
+#if (O_FIFO & PROC_O_LIBRARY)
+#error "O_FIFO collides with a library open flag"
+#endif
+
+#if (O_LOG & (PROC_O_LIBRARY | O_FIFO))
+#error "O_LOG collides with another open flag"
+#endif
+
+#if (O_BY_HANDLE & (PROC_O_LIBRARY | O_FIFO | O_LOG))
+#error "O_BY_HANDLE collides with another open flag"
+#endif
+
+
+/* Exported macros ---------------------------------------- */
+
+#define LIST_CURSOR_INITIALIZER     { 0, 0, LIST_CURSOR_DIRS }
+
+// Read, write, seek, truncate, share and close codes carry the open file handle in the top bits
+#define IO_HANDLE(code)             (((code) >> 12) & 0xF)
+#define IO_CODE(code)               ((code) & 0x0FFF)
+#define IO_HANDLE_CODE(h,code)      ((uint16_t)(((h) << 12) | IO_CODE(code)))
+
+// Proc read and write codes have to stay below the handle bits
+#define PROC_IO_CODES               (IO_READ_AT | IO_READ_VECTOR | IO_READ_RING_SETUP | IO_READ_RING_ENTER | IO_WRITE_AT | IO_WRITE_VECTOR)
+
+#if (PROC_IO_CODES != IO_CODE(PROC_IO_CODES))
+#error "Proc read and write codes overlap the open file handle bits"
+#endif
+
+
+/* Exported functions ------------------------------------- */
+
+#endif
@@ -9,6 +9,8 @@
 /* Includes ----------------------------------------------- */
 #include <rfs.h>
 #include <mman.h>
+#include <stdlib.h>
+#include <string.h>
 
 
 /* Private types ------------------------------------------ */
@@ -78,9 +80,13 @@ typedef struct
 #define LIB_TYPE	0x2
 #define OBJ_TYPE	0x3
 
+#define RFS_PAGE_SIZE   4096
+
 
 
 /* Private macros ----------------------------------------- */
+#define ALIGN_DOWN(m,a)	((m) & (~(a - 1)))
+#define ALIGN_UP(m,a)	(((m) + (a - 1)) & (~(a - 1)))
 
 
 
@@ -95,6 +101,9 @@ static struct
 	device_t	*devices;
 	file_t		*files;
 	char        *strings;
+    uint32_t    base;
+    size_t      size;
+    uint16_t    *refs;
 }Rfs;
 
 
@@ -116,6 +125,25 @@ file_t *RfsGetFile(uint32_t offset)
 	return (file_t *)((uint32_t)Rfs.hdr + offset);
 }
 
+// Unmaps every run of pages no file references, in [first, last)
+void RfsUnmapUnused(uint32_t first, uint32_t last)
+{
+    uint32_t page = first;
+    while(page < last)
+    {
+        if(Rfs.refs[page] != 0)
+        {
+            page++;
+            continue;
+        }
+
+        uint32_t run = page;
+        for( ; page < last && Rfs.refs[page] == 0; page++) {}
+
+        munmap((void*)(Rfs.base + run * RFS_PAGE_SIZE), (page - run) * RFS_PAGE_SIZE);
+    }
+}
+
 
 /* Private functions -------------------------------------- */
 
@@ -126,27 +154,101 @@ int32_t RfsInit()
         return E_INVAL;
     }
 
-    Rfs.hdr = (header_t*)mmap(NULL, 0, (PROT_READ |PROT_WRITE), (MAP_PHYS | MAP_ANON | MAP_PRIVATE), NOFD, RFS_ID);
+    // Image is kept read only, files backed by it are copied on the first write
+    Rfs.hdr = (header_t*)mmap(NULL, 0, PROT_READ, (MAP_PHYS | MAP_ANON | MAP_PRIVATE), NOFD, RFS_ID);
 
     if(Rfs.hdr == NULL)
     {
         return E_ERROR;
     }
 
+    Rfs.base = (uint32_t)Rfs.hdr;
+    Rfs.size = Rfs.hdr->fs_size;
+
     return E_OK;
 }
 
 int32_t RfsDelete()
+{
+    if(Rfs.base == 0)
+    {
+        return E_INVAL;
+    }
+
+    if(Rfs.hdr != NULL)
+    {
+        munmap((void*)Rfs.base, Rfs.size);
+    }
+
+    free(Rfs.refs);
+    Rfs.refs = NULL;
+    Rfs.hdr = NULL;
+    Rfs.base = 0;
+
+    return E_OK;
+}
+
+int32_t RfsTrim()
 {
     if(Rfs.hdr == NULL)
     {
         return E_INVAL;
     }
 
-    munmap((void*)Rfs.hdr, Rfs.hdr->fs_size);
+    uint32_t pages = ALIGN_UP(Rfs.size, RFS_PAGE_SIZE) / RFS_PAGE_SIZE;
+    Rfs.refs = (uint16_t*)malloc(pages * sizeof(uint16_t));
 
+    if(Rfs.refs == NULL)
+    {
+        return E_ERROR;
+    }
+
+    memset(Rfs.refs, 0x0, pages * sizeof(uint16_t));
+
+    // Count the files referencing each page, boundary pages may be shared by two or more
+    uint32_t i;
+    for(i = 0; i < Rfs.hdr->files_count; i++)
+    {
+        uint32_t page = Rfs.files[i].data_off / RFS_PAGE_SIZE;
+        uint32_t last = (Rfs.files[i].data_off + Rfs.files[i].size + RFS_PAGE_SIZE - 1) / RFS_PAGE_SIZE;
+        for( ; page < last; page++)
+        {
+            Rfs.refs[page]++;
+        }
+    }
+
+    // Headers, tables and strings are no longer accessible from this point
     Rfs.hdr = NULL;
 
+    RfsUnmapUnused(0, pages);
+
+    return E_OK;
+}
+
+int32_t RfsRelease(void* addr, size_t size)
+{
+    uint32_t start = (uint32_t)addr;
+
+    if(Rfs.refs == NULL || start < Rfs.base || (start + size) > (Rfs.base + Rfs.size))
+    {
+        return E_INVAL;
+    }
+
+    uint32_t first = (start - Rfs.base) / RFS_PAGE_SIZE;
+    uint32_t last = (start - Rfs.base + size + RFS_PAGE_SIZE - 1) / RFS_PAGE_SIZE;
+    uint32_t page;
+
+    // Boundary pages go once the last file sharing them is released
+    for(page = first; page < last; page++)
+    {
+        if(Rfs.refs[page] != 0)
+        {
+            Rfs.refs[page]--;
+        }
+    }
+
+    RfsUnmapUnused(first, last);
+
     return E_OK;
 }
 
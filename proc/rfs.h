@@ -45,6 +45,10 @@ int32_t RfsFileParse(uint32_t file, char** name, int32_t* type, void** data, siz
 
 int32_t RfsDelete();
 
+int32_t RfsTrim();
+
+int32_t RfsRelease(void* addr, size_t size);
+
 char* RfsGetVersion();
 
 char* RfsGetArch();
@@ -0,0 +1,166 @@
+/**
+ * @file        ring.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Shared Submission/Completion Ring implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <ring.h>
+#include <stdlib.h>
+#include <string.h>
+#include <mman.h>
+
+
+/* Private types ------------------------------------------ */
+
+// Geometry and server indexes are kept here, the client can rewrite the shared header
+struct Ring
+{
+    ring_hdr_t* hdr;
+    size_t   size;
+    uint32_t entries;
+    uint32_t sqOffset;
+    uint32_t cqOffset;
+    uint32_t dataOffset;
+    uint32_t dataSize;
+    uint32_t sqHead;
+    uint32_t cqTail;
+};
+
+
+/* Private constants -------------------------------------- */
+#define RING_PAGE_SIZE      4096
+
+
+/* Private macros ----------------------------------------- */
+#define ALIGN_UP(m,a)	(((m) + (a - 1)) & (~(a - 1)))
+
+
+/* Private variables -------------------------------------- */
+
+
+/* Private function prototypes ---------------------------- */
+
+
+/* Private functions -------------------------------------- */
+
+ring_t* RingCreate(uint32_t entries, uint32_t dataSize)
+{
+    // Indexes wrap with a mask
+    if((entries == 0) || (entries > RING_MAX_ENTRIES) || (entries & (entries - 1)) || (dataSize > RING_MAX_DATA))
+    {
+        return NULL;
+    }
+
+    ring_t* ring = (ring_t*)malloc(sizeof(ring_t));
+
+    if(ring == NULL)
+    {
+        return NULL;
+    }
+
+    ring->entries = entries;
+    ring->sqOffset = ALIGN_UP(sizeof(ring_hdr_t), 8);
+    ring->cqOffset = ring->sqOffset + entries * sizeof(ring_sqe_t);
+    ring->dataOffset = ALIGN_UP(ring->cqOffset + entries * sizeof(ring_cqe_t), 8);
+    ring->dataSize = dataSize;
+    ring->size = ALIGN_UP(ring->dataOffset + dataSize, RING_PAGE_SIZE);
+    ring->sqHead = 0;
+    ring->cqTail = 0;
+
+    // Shared with the client through ShareObject like the file data
+    ring->hdr = (ring_hdr_t*)mmap(NULL, ring->size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANON, NOFD, 0x0);
+
+    if(ring->hdr == NULL)
+    {
+        free(ring);
+        return NULL;
+    }
+
+    // Header tells the client the layout, the server never reads it back
+    memset(ring->hdr, 0, sizeof(ring_hdr_t));
+    ring->hdr->entries = ring->entries;
+    ring->hdr->sqOffset = ring->sqOffset;
+    ring->hdr->cqOffset = ring->cqOffset;
+    ring->hdr->dataOffset = ring->dataOffset;
+    ring->hdr->dataSize = ring->dataSize;
+
+    return ring;
+}
+
+void RingDelete(ring_t* ring)
+{
+    if(ring != NULL)
+    {
+        munmap(ring->hdr, ring->size);
+        free(ring);
+    }
+}
+
+ring_hdr_t* RingShared(ring_t* ring)
+{
+    return ring->hdr;
+}
+
+uint32_t RingDrain(ring_t* ring, ring_op_t op, void* arg)
+{
+    ring_hdr_t* hdr = ring->hdr;
+    ring_sqe_t* sq = (ring_sqe_t*)((char*)hdr + ring->sqOffset);
+    ring_cqe_t* cq = (ring_cqe_t*)((char*)hdr + ring->cqOffset);
+    char* data = (char*)hdr + ring->dataOffset;
+    uint32_t mask = ring->entries - 1;
+    uint32_t done = 0;
+
+    uint32_t head = ring->sqHead;
+    uint32_t tail = hdr->sqTail;
+
+    // Entries written by the client before it moved the tail are visible from here
+    __sync_synchronize();
+
+    // A bogus tail from the client is clamped to one queue worth of entries
+    if((tail - head) > ring->entries)
+    {
+        tail = head + ring->entries;
+    }
+
+    while(head != tail)
+    {
+        // Submissions wait while the completion queue is full, a bogus head counts as full
+        if((ring->cqTail - hdr->cqHead) >= ring->entries)
+        {
+            break;
+        }
+
+        // Client may rewrite the entry, work on a copy
+        ring_sqe_t sqe = sq[head & mask];
+        int32_t result;
+
+        if((sqe.data > ring->dataSize) || (sqe.size > (ring->dataSize - sqe.data)))
+        {
+            result = -1;
+        }
+        else
+        {
+            result = op(arg, &sqe, &data[sqe.data]);
+        }
+
+        ring_cqe_t* cqe = &cq[ring->cqTail & mask];
+        cqe->tag = sqe.tag;
+        cqe->result = result;
+
+        head++;
+        done++;
+        ring->cqTail++;
+
+        // Completion is published before the indexes move
+        __sync_synchronize();
+        hdr->cqTail = ring->cqTail;
+        hdr->sqHead = head;
+    }
+
+    ring->sqHead = head;
+
+    return done;
+}
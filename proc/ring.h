@@ -0,0 +1,42 @@
+/**
+ * @file        ring.h
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Shared Submission/Completion Ring Definition Header File
+*/
+
+#ifndef _RING_H_
+#define _RING_H_
+
+/* Includes ----------------------------------------------- */
+#include <types.h>
+#include <proc_msg.h>
+
+
+/* Exported types ----------------------------------------- */
+typedef struct Ring ring_t;
+
+// Executes one submission, data points to the buffer in the data area
+typedef int32_t (*ring_op_t)(void* arg, ring_sqe_t* sqe, char* data);
+
+
+/* Exported constants ------------------------------------- */
+#define RING_MAX_ENTRIES    1024
+#define RING_MAX_DATA       (1024 * 1024)
+
+
+/* Exported macros ---------------------------------------- */
+
+
+/* Exported functions ------------------------------------- */
+
+ring_t* RingCreate(uint32_t entries, uint32_t dataSize);
+
+void RingDelete(ring_t* ring);
+
+ring_hdr_t* RingShared(ring_t* ring);
+
+uint32_t RingDrain(ring_t* ring, ring_op_t op, void* arg);
+
+#endif
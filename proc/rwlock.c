@@ -0,0 +1,102 @@
+/**
+ * @file        rwlock.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Readers/Writer Lock implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <rwlock.h>
+
+
+/* Private types ------------------------------------------ */
+
+
+/* Private constants -------------------------------------- */
+
+
+/* Private macros ----------------------------------------- */
+
+
+/* Private variables -------------------------------------- */
+
+
+/* Private function prototypes ---------------------------- */
+
+
+/* Private functions -------------------------------------- */
+
+int32_t RwLockInit(rwlock_t* rwlock)
+{
+    rwlock->readers = 0;
+    rwlock->writers = 0;
+    rwlock->waiting = 0;
+
+    if(MutexInit(&rwlock->lock) != E_OK)
+    {
+        return E_ERROR;
+    }
+
+    return CondInit(&rwlock->cond);
+}
+
+int32_t RwLockRead(rwlock_t* rwlock)
+{
+    MutexLock(&rwlock->lock);
+
+    // Waiting writers have priority so they are not starved by readers
+    while(rwlock->writers || rwlock->waiting)
+    {
+        CondWait(&rwlock->cond, &rwlock->lock);
+    }
+
+    rwlock->readers++;
+
+    MutexUnlock(&rwlock->lock);
+
+    return E_OK;
+}
+
+int32_t RwLockWrite(rwlock_t* rwlock)
+{
+    MutexLock(&rwlock->lock);
+
+    rwlock->waiting++;
+
+    while(rwlock->writers || rwlock->readers)
+    {
+        CondWait(&rwlock->cond, &rwlock->lock);
+    }
+
+    rwlock->waiting--;
+    rwlock->writers = 1;
+
+    MutexUnlock(&rwlock->lock);
+
+    return E_OK;
+}
+
+int32_t RwLockUnlock(rwlock_t* rwlock)
+{
+    MutexLock(&rwlock->lock);
+
+    if(rwlock->writers)
+    {
+        rwlock->writers = 0;
+    }
+    else if(rwlock->readers)
+    {
+        rwlock->readers--;
+    }
+
+    // Last owner wakes everyone waiting for the lock
+    if(!rwlock->readers)
+    {
+        CondBroadcast(&rwlock->cond);
+    }
+
+    MutexUnlock(&rwlock->lock);
+
+    return E_OK;
+}
@@ -0,0 +1,47 @@
+/**
+ * @file        rwlock.h
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Readers/Writer Lock Definition Header File
+*/
+
+#ifndef _RWLOCK_H_
+#define _RWLOCK_H_
+
+/* Includes ----------------------------------------------- */
+#include <types.h>
+#include <mutex.h>
+#include <cond.h>
+
+
+/* Exported types ----------------------------------------- */
+typedef struct
+{
+    mutex_t  lock;
+    cond_t   cond;
+    uint16_t readers;
+    uint16_t writers;
+    uint16_t waiting;
+}rwlock_t;
+
+
+/* Exported constants ------------------------------------- */
+
+
+/* Exported macros ---------------------------------------- */
+
+#define RWLOCK_INITIALIZER  { MUTEX_INITIALIZER, COND_INITIALIZER, 0, 0, 0 }
+
+
+/* Exported functions ------------------------------------- */
+
+int32_t RwLockInit(rwlock_t* rwlock);
+
+int32_t RwLockRead(rwlock_t* rwlock);
+
+int32_t RwLockWrite(rwlock_t* rwlock);
+
+int32_t RwLockUnlock(rwlock_t* rwlock);
+
+#endif
@@ -0,0 +1,243 @@
+/**
+ * @file        stats.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       IO Handler Statistics implementation
+*/
+
+/* Includes ----------------------------------------------- */
+#include <stats.h>
+#include <proc.h>
+#include <connection.h>
+#include <stdio.h>
+
+#ifdef PROC_STATS
+
+/* Private types ------------------------------------------ */
+
+typedef struct
+{
+    uint32_t ops;
+    uint32_t errors;
+    uint64_t bytes;
+    uint32_t latency[STATS_BUCKETS];
+}op_stats_t;
+
+// Request being served, found again by its rcvid when the reply is sent
+typedef struct
+{
+    int32_t    busy;
+    int32_t    rcvid;
+    connect_t* con;
+    uint32_t   op;
+    uint32_t   start;
+    uint32_t   written;
+}call_t;
+
+typedef struct
+{
+    char*  buffer;
+    size_t len;
+    size_t size;
+}render_t;
+
+
+/* Private constants -------------------------------------- */
+
+// More than the dispatcher tasks, requests beyond it are not accounted
+#define STATS_CALLS         8
+#define STATS_NO_CALL       (-1)
+
+// Longest line rendered
+#define STATS_LINE_MAX      512
+
+
+/* Private macros ----------------------------------------- */
+
+
+/* Private variables -------------------------------------- */
+
+static op_stats_t stats[STATS_OPS];
+
+static call_t calls[STATS_CALLS];
+
+static const char* const names[STATS_OPS] = {"info", "open", "close", "read", "write", "seek", "truncate", "share"};
+
+
+/* Private function prototypes ---------------------------- */
+
+uint32_t StatsBucket(uint32_t ticks)
+{
+    return ((ticks == 0) ? (0) : (31 - __builtin_clz(ticks)));
+}
+
+void StatsRecord(call_t* call, int32_t status, uint32_t size)
+{
+    op_stats_t* op = &stats[call->op];
+
+    // Writes reply with the bytes written, reads may have sent their data ahead of the reply
+    uint32_t bytes = ((call->op == STATS_WRITE) ? ((status > 0) ? (status) : (0)) : (size + call->written));
+
+    __sync_fetch_and_add(&op->ops, 1);
+    __sync_fetch_and_add(&op->bytes, (uint64_t)bytes);
+    __sync_fetch_and_add(&op->latency[StatsBucket(StatsClock() - call->start)], 1);
+
+    if(status < 0)
+    {
+        __sync_fetch_and_add(&op->errors, 1);
+    }
+
+    connect_t* con = call->con;
+
+    if(con != NULL)
+    {
+        __sync_fetch_and_add(&con->ops, 1);
+        __sync_fetch_and_add(&con->bytes, bytes);
+    }
+}
+
+call_t* StatsCall(int32_t rcvid)
+{
+    uint32_t i;
+    for(i = 0; i < STATS_CALLS; i++)
+    {
+        if(calls[i].busy && (calls[i].rcvid == rcvid))
+        {
+            return &calls[i];
+        }
+    }
+
+    return NULL;
+}
+
+uint32_t StatsRoom(render_t* render)
+{
+    return ((render->size - render->len) > STATS_LINE_MAX);
+}
+
+void StatsRenderConnection(connect_t* con, void* arg)
+{
+    render_t* render = (render_t*)arg;
+
+    if(StatsRoom(render))
+    {
+        render->len += sprintf(&render->buffer[render->len], "%d\t%u\t%u\n", con->scoid, con->ops, con->bytes);
+    }
+}
+
+size_t StatsRender(char* buffer, size_t size)
+{
+    render_t render = {buffer, 0, size};
+    uint32_t i, j;
+
+    render.len += sprintf(&buffer[render.len], "Op\tOps\tErrors\tKBytes\n");
+
+    for(i = 0; i < STATS_OPS; i++)
+    {
+        render.len += sprintf(&buffer[render.len], "%s\t%u\t%u\t%u\n", names[i], stats[i].ops, stats[i].errors, (uint32_t)(stats[i].bytes >> 10));
+    }
+
+    // Only used buckets are listed as log2(ticks):count
+#if defined(PROC_STATS_PMU) && defined(__arm__)
+    render.len += sprintf(&buffer[render.len], "\nLatency (cycles)\n");
+#else
+    render.len += sprintf(&buffer[render.len], "\nLatency (ticks of %u Hz)\n", ClockFrequency());
+#endif
+
+    for(i = 0; (i < STATS_OPS) && StatsRoom(&render); i++)
+    {
+        render.len += sprintf(&buffer[render.len], "%s\t", names[i]);
+
+        for(j = 0; j < STATS_BUCKETS; j++)
+        {
+            if(stats[i].latency[j] != 0)
+            {
+                render.len += sprintf(&buffer[render.len], "%u:%u ", j, stats[i].latency[j]);
+            }
+        }
+
+        buffer[render.len++] = '\n';
+    }
+
+    render.len += sprintf(&buffer[render.len], "\nConnection\tOps\tBytes\n");
+
+    ConnectionForEach(StatsRenderConnection, &render);
+
+    uint32_t dirs, files;
+    size_t data;
+    ProcTreeUsage(&dirs, &files, &data);
+
+    if(StatsRoom(&render))
+    {
+        render.len += sprintf(&buffer[render.len], "\nDirs: %u\nFiles: %u\nData: 0x%x\n", dirs, files, data);
+    }
+
+    return render.len;
+}
+
+
+/* Private functions -------------------------------------- */
+
+void StatsBegin(int32_t rcvid, connect_t* con, uint32_t op)
+{
+    uint32_t i;
+    for(i = 0; i < STATS_CALLS; i++)
+    {
+        if(__sync_bool_compare_and_swap(&calls[i].busy, 0, 1))
+        {
+            calls[i].con = con;
+            calls[i].op = op;
+            calls[i].written = 0;
+            calls[i].start = StatsClock();
+            __sync_synchronize();
+            // Slot is only matched once it is complete
+            calls[i].rcvid = rcvid;
+            return;
+        }
+    }
+}
+
+void StatsWritten(int32_t rcvid, uint32_t bytes)
+{
+    // Only the task serving the request writes its slot
+    call_t* call = StatsCall(rcvid);
+
+    if(call != NULL)
+    {
+        call->written += bytes;
+    }
+}
+
+void StatsEnd(int32_t rcvid, int32_t status, uint32_t size)
+{
+    call_t* call = StatsCall(rcvid);
+
+    if(call == NULL)
+    {
+        return;
+    }
+
+    StatsRecord(call, status, size);
+
+    call->rcvid = STATS_NO_CALL;
+    __sync_synchronize();
+    call->busy = 0;
+}
+
+int32_t StatsInit()
+{
+    uint32_t i;
+    for(i = 0; i < STATS_CALLS; i++)
+    {
+        calls[i].rcvid = STATS_NO_CALL;
+    }
+
+    ProcTreeWrite();
+    file_t* file = ProcFileGenerated(STATS_FILE, StatsRender, FILE_GENERATE_TTL);
+    ProcTreeUnlock();
+
+    return ((file != NULL) ? (E_OK) : (E_ERROR));
+}
+
+#endif
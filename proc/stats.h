@@ -0,0 +1,72 @@
+/**
+ * @file        stats.h
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       IO Handler Statistics Definition Header File
+*/
+
+#ifndef _STATS_H_
+#define _STATS_H_
+
+/* Includes ----------------------------------------------- */
+#include <types.h>
+#include <connection.h>
+#include <clock.h>
+
+
+/* Exported types ----------------------------------------- */
+
+// Handlers accounted separately
+enum
+{
+    STATS_INFO,
+    STATS_OPEN,
+    STATS_CLOSE,
+    STATS_READ,
+    STATS_WRITE,
+    STATS_SEEK,
+    STATS_TRUNCATE,
+    STATS_SHARE,
+    STATS_OPS
+};
+
+
+/* Exported constants ------------------------------------- */
+#define STATS_FILE          "/stats"
+
+// Latency buckets, bucket n counts requests taking [2^n, 2^(n+1)) clock ticks
+#define STATS_BUCKETS       32
+
+
+/* Exported macros ---------------------------------------- */
+
+
+/* Exported functions ------------------------------------- */
+
+#ifdef PROC_STATS
+static inline uint32_t StatsClock()
+{
+#if defined(PROC_STATS_PMU) && defined(__arm__)
+    // PMU cycle counter, the kernel has to grant user mode access to it
+    uint32_t cycles;
+    __asm__ volatile("mrc p15, 0, %0, c9, c13, 0" : "=r"(cycles));
+    return cycles;
+#else
+    // Latencies are short, the low word of the monotonic clock does not wrap within one
+    return (uint32_t)ClockTicks();
+#endif
+}
+
+// Connection is held by the caller until the request ends, NULL if it is not accounted to one
+void StatsBegin(int32_t rcvid, connect_t* con, uint32_t op);
+
+// Reply data sent with MsgWrite before the reply
+void StatsWritten(int32_t rcvid, uint32_t bytes);
+
+void StatsEnd(int32_t rcvid, int32_t status, uint32_t size);
+
+int32_t StatsInit();
+#endif
+
+#endif
@@ -4,7 +4,6 @@
 #include <types.h>
 #include <fs.h>
 #include <io_types.h>
-#include <list.h>
 
 #define CONNECT_NO_ACCESS  -1
 #define CONNECT_INVALID    -1
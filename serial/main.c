@@ -7,9 +7,13 @@
 #include <string.h>
 
 #include <uart.h>
+#include <trace.h>
 
 #define ROUND_UP(m,a)			(((m) + ((a) - 1)) & (~((a) - 1)))
 
+// Every reply closes the trace record of the message being handled
+#define MsgRespond(rcvid, status, buffer, size)     TraceRespond(rcvid, status, buffer, size)
+
 static mutex_t stdLock;
 
 static io_funcs_t   out_io_funcs;
@@ -38,8 +42,27 @@ void StdWrite(const char *buffer)
     MutexUnlock(&stdLock);
 }
 
+int32_t InfoStd(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uint32_t offset)
+{
+    TraceBegin(rcvid, scoid, hdr);
+
+    // Only the message trace is exposed
+    if(!TRACE_INFO(hdr->code))
+    {
+        return MsgRespond(rcvid, E_INVAL, NULL, 0);
+    }
+
+    const char* data;
+    uint32_t size = hdr->rbytes;
+    int32_t ret = TraceControl(hdr->code, &data, &size);
+
+    return MsgRespond(rcvid, ret, data, size);
+}
+
 int32_t ReadStdIn(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uint32_t offset)
 {
+    TraceBegin(rcvid, scoid, hdr);
+
     if(hdr->rbytes == 0)
     {
         // Invalid request
@@ -85,13 +108,18 @@ int32_t ReadStdIn(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uin
 
         MsgRespond(rcvid, size, (const char *)buffer, size);
     }
+    else
+    {
+        // Every request is answered, its trace slot is released by the reply
+        return MsgRespond(rcvid, E_INVAL, NULL, 0);
+    }
 
     return E_OK;
 }
 
 int32_t WriteStdOut(int32_t rcvid, int32_t scoid, io_hdr_t* hdr, char* buffer, uint32_t offset)
 {
-    (void)scoid;
+    TraceBegin(rcvid, scoid, hdr);
 
     buffer[offset] = '\0';
     StdWrite((const char *)buffer);
@@ -128,7 +156,9 @@ int main(/*int argc, const char* argv[]*/)
     dispatch_attr_t in_attr  = {0x0, 1024, 1023, 1};
 
     out_io_funcs.io_write = WriteStdOut;
+    out_io_funcs.io_info  = InfoStd;
     in_io_funcs.io_read   = ReadStdIn;
+    in_io_funcs.io_info   = InfoStd;
 
     dispatch_t* out_disp = DispatcherAttach("/dev/stdout", &out_attr, &out_io_funcs, &out_ctrl_funcs);
     dispatch_t* in_disp =  DispatcherAttach("/dev/stdin",  &in_attr,  &in_io_funcs,  &in_ctrl_funcs);
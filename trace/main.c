@@ -0,0 +1,112 @@
+#include <types.h>
+#include <io_types.h>
+#include <server.h>
+#include <stdio.h>
+#include <string.h>
+#include <trace.h>
+
+// Dump buffer, header followed by the whole ring
+static uint32_t dump[(sizeof(trace_hdr_t) + sizeof(trace_record_t) * TRACE_RECORDS) / sizeof(uint32_t)];
+
+int32_t TraceSend(const char* path, uint16_t code, uint32_t* replySize)
+{
+    char* remaining = NULL;
+    int32_t fd = connect(path, &remaining);
+
+    if(fd == -1)
+    {
+        printf("Server %s not found\n", path);
+        return E_INVAL;
+    }
+
+    // Message header
+    io_hdr_t hdr;
+    hdr.type = _IO_INFO;
+    hdr.code = code;
+    hdr.sbytes = 0;
+    hdr.rbytes = ((code == TRACE_INFO_DUMP) ? (sizeof(dump)) : (0));
+
+    int32_t ret = MsgSend(fd, &hdr, NULL, (const char*)dump, replySize);
+
+    ConnectDetach(fd);
+
+    return ret;
+}
+
+int32_t TraceDump(const char* path)
+{
+    uint32_t replySize = 0;
+
+    if(TraceSend(path, TRACE_INFO_DUMP, &replySize) != E_OK)
+    {
+        return E_ERROR;
+    }
+
+    if(replySize < sizeof(trace_hdr_t))
+    {
+        return E_ERROR;
+    }
+
+    // Words are printed as text lines, trace_decode turns a captured console log into a timeline
+    const uint32_t RECORD_WORDS = sizeof(trace_record_t) / sizeof(uint32_t);
+    trace_record_t* records = (trace_record_t*)((trace_hdr_t*)dump + 1);
+    uint32_t count = (replySize - sizeof(trace_hdr_t)) / sizeof(trace_record_t);
+    uint32_t i, j;
+
+    printf("@trace");
+    for(j = 0; j < (sizeof(trace_hdr_t) / sizeof(uint32_t)); j++)
+    {
+        printf(" %x", dump[j]);
+    }
+    printf("\n");
+
+    for(i = 0; i < count; i++)
+    {
+        // Unused records and records rewritten during the dump are not printed
+        if((records[i].seq == 0) || (((records[i].seq - 1) % count) != i))
+        {
+            continue;
+        }
+
+        uint32_t* words = (uint32_t*)&records[i];
+
+        printf("@trace");
+        for(j = 0; j < RECORD_WORDS; j++)
+        {
+            printf(" %x", words[j]);
+        }
+        printf("\n");
+    }
+
+    return E_OK;
+}
+
+int main(int argc, const char* argv[])
+{
+    if(argc != 3)
+    {
+        printf("Usage: trace on|off|dump server\n");
+        return E_INVAL;
+    }
+
+    uint32_t replySize = 0;
+
+    if(!strcmp(argv[1], "on"))
+    {
+        return TraceSend(argv[2], TRACE_INFO_ON, &replySize);
+    }
+
+    if(!strcmp(argv[1], "off"))
+    {
+        return TraceSend(argv[2], TRACE_INFO_OFF, &replySize);
+    }
+
+    if(!strcmp(argv[1], "dump"))
+    {
+        return TraceDump(argv[2]);
+    }
+
+    printf("Unknown command %s\n", argv[1]);
+
+    return E_INVAL;
+}
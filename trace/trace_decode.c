@@ -0,0 +1,164 @@
+/**
+ * @file        trace_decode.c
+ * @author      Carlos Fernandes
+ * @version     1.0
+ * @date        24 August, 2020
+ * @brief       Host side decoder of server message trace dumps
+*/
+
+/* Includes ----------------------------------------------- */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+
+/* Private types ------------------------------------------ */
+
+// Mirrors trace_record_t in common/trace.h, one dump line per record
+typedef struct
+{
+    uint32_t seq;
+    uint32_t time;
+    uint32_t duration;
+    int32_t  rcvid;
+    int32_t  scoid;
+    int32_t  status;
+    uint32_t bytes;
+    uint32_t typeCode;
+}record_t;
+
+
+/* Private constants -------------------------------------- */
+#define TRACE_MAGIC         0x54524345
+#define TRACE_PREFIX        "@trace"
+#define HEADER_WORDS        4
+#define RECORD_WORDS        (sizeof(record_t) / sizeof(uint32_t))
+#define MAX_RECORDS         4096
+#define LINE_SIZE           512
+
+
+/* Private variables -------------------------------------- */
+
+static record_t records[MAX_RECORDS];
+static uint32_t count = 0;
+static uint32_t dumps = 0;
+
+
+/* Private function prototypes ---------------------------- */
+
+int RecordCompare(const void* a, const void* b)
+{
+    uint32_t x = ((const record_t*)a)->seq;
+    uint32_t y = ((const record_t*)b)->seq;
+
+    return ((x < y) ? (-1) : ((x > y) ? (1) : (0)));
+}
+
+void TimelinePrint()
+{
+    if(count == 0)
+    {
+        return;
+    }
+
+    qsort(records, count, sizeof(record_t), RecordCompare);
+
+    printf("Dump %u\n", dumps);
+    printf("%8s %10s %10s %10s %6s %6s %4s %6s %8s %6s\n", "seq", "time", "delta", "duration", "scoid", "rcvid", "type", "code", "bytes", "status");
+
+    uint32_t i;
+    for(i = 0; i < count; i++)
+    {
+        record_t* record = &records[i];
+
+        // Records overwritten before the dump leave holes in the sequence
+        if((i > 0) && (record->seq != (records[i - 1].seq + 1)))
+        {
+            printf("%8s %u records lost\n", "...", record->seq - records[i - 1].seq - 1);
+        }
+
+        printf("%8u %10u %10u %10u %6d %6d %4u 0x%04x %8u %6d\n", record->seq, record->time - records[0].time,
+               ((i > 0) ? (record->time - records[i - 1].time) : (0)), record->duration, record->scoid, record->rcvid,
+               record->typeCode & 0xFFFF, record->typeCode >> 16, record->bytes, record->status);
+    }
+
+    printf("\n");
+
+    count = 0;
+}
+
+uint32_t LineParse(char* line, uint32_t* words, uint32_t max)
+{
+    uint32_t n = 0;
+    char* token = strtok(line + strlen(TRACE_PREFIX), " \t\r\n");
+
+    for( ; (token != NULL) && (n < max); token = strtok(NULL, " \t\r\n"))
+    {
+        words[n++] = (uint32_t)strtoul(token, NULL, 16);
+    }
+
+    return n;
+}
+
+
+/* Private functions -------------------------------------- */
+
+int main(int argc, const char* argv[])
+{
+    FILE* in = stdin;
+
+    if(argc == 2)
+    {
+        in = fopen(argv[1], "r");
+
+        if(in == NULL)
+        {
+            fprintf(stderr, "File %s not found\n", argv[1]);
+            return 1;
+        }
+    }
+    else if(argc > 2)
+    {
+        fprintf(stderr, "Usage: trace_decode [console log]\n");
+        return 1;
+    }
+
+    char line[LINE_SIZE];
+
+    // Console output around the dump lines is ignored
+    while(fgets(line, sizeof(line), in) != NULL)
+    {
+        char* start = strstr(line, TRACE_PREFIX);
+
+        if(start == NULL)
+        {
+            continue;
+        }
+
+        uint32_t words[RECORD_WORDS];
+        uint32_t n = LineParse(start, words, RECORD_WORDS);
+
+        // Every dump starts with its header
+        if((n == HEADER_WORDS) && (words[0] == TRACE_MAGIC))
+        {
+            TimelinePrint();
+            dumps++;
+            continue;
+        }
+
+        if((n == RECORD_WORDS) && (count < MAX_RECORDS))
+        {
+            memcpy(&records[count++], words, sizeof(record_t));
+        }
+    }
+
+    TimelinePrint();
+
+    if(in != stdin)
+    {
+        fclose(in);
+    }
+
+    return 0;
+}